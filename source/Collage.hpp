@@ -0,0 +1,724 @@
+#pragma once
+
+#include "IFS.hpp"
+#include "Image.hpp"
+
+namespace collage
+{
+	struct Isometry
+	{
+		std::int32_t a, b, c, d, e, f;
+	};
+
+	static constexpr std::int32_t numIsometries = 8;
+
+	inline const Isometry& getIsometry(const std::int32_t index)
+	{
+		static const Isometry isometries[numIsometries] = {
+			{ 1, 0, 0, 1, 0, 0 },
+			{ 0, -1, 1, 0, 1, 0 },
+			{ -1, 0, 0, -1, 1, 1 },
+			{ 0, 1, -1, 0, 0, 1 },
+			{ -1, 0, 0, 1, 1, 0 },
+			{ 1, 0, 0, -1, 0, 1 },
+			{ 0, 1, 1, 0, 0, 0 },
+			{ 0, -1, -1, 0, 1, 1 },
+		};
+
+		return isometries[index];
+	}
+
+	class Bitmap
+	{
+	public:
+		static constexpr std::int32_t maxSize = 1024;
+		static constexpr std::size_t maxWords = maxSize / 64;
+
+	private:
+		std::int32_t size;
+		std::size_t wordsPerRow;
+		std::vector<std::uint64_t> words;
+
+	public:
+		Bitmap(const std::int32_t size = 0) :
+			size(glm::clamp(size, 0, maxSize)), wordsPerRow((this->size + 63) / 64), words(this->wordsPerRow * this->size, 0)
+		{
+
+		}
+
+		std::int32_t getSize() const
+		{
+			return this->size;
+		}
+
+		std::size_t getWordsPerRow() const
+		{
+			return this->wordsPerRow;
+		}
+
+		const std::uint64_t* getRow(const std::int32_t y) const
+		{
+			return this->words.data() + y * this->wordsPerRow;
+		}
+
+		bool get(const std::int32_t x, const std::int32_t y) const
+		{
+			return (this->getRow(y)[x >> 6] >> (x & 63)) & 1;
+		}
+
+		void set(const std::int32_t x, const std::int32_t y)
+		{
+			this->words[y * this->wordsPerRow + (x >> 6)] |= std::uint64_t(1) << (x & 63);
+		}
+
+		std::uint64_t count() const
+		{
+			std::uint64_t count = 0;
+
+			for (const auto word : this->words)
+			{
+				count += ifs::countBits(word);
+			}
+
+			return count;
+		}
+
+		void extract(const std::int32_t x, const std::int32_t y, const std::int32_t width, std::uint64_t* window) const
+		{
+			const std::uint64_t* row = this->getRow(y);
+
+			std::size_t numWords = (width + 63) / 64;
+			std::size_t first = x >> 6;
+			std::int32_t shift = x & 63;
+
+			for (std::size_t w = 0; w < numWords; w++)
+			{
+				std::uint64_t low = first + w < this->wordsPerRow ? row[first + w] : 0;
+				std::uint64_t high = shift > 0 && first + w + 1 < this->wordsPerRow ? row[first + w + 1] : 0;
+
+				window[w] = shift > 0 ? (low >> shift) | (high << (64 - shift)) : low;
+			}
+
+			if (width & 63)
+			{
+				window[numWords - 1] &= (std::uint64_t(1) << (width & 63)) - 1;
+			}
+		}
+
+		Bitmap dilate() const
+		{
+			Bitmap dilated(this->size);
+
+			std::vector<std::uint64_t> spread(this->wordsPerRow);
+
+			for (std::int32_t y = 0; y < this->size; y++)
+			{
+				const std::uint64_t* row = this->getRow(y);
+
+				for (std::size_t w = 0; w < this->wordsPerRow; w++)
+				{
+					std::uint64_t previous = w > 0 ? row[w - 1] >> 63 : 0;
+					std::uint64_t next = w + 1 < this->wordsPerRow ? row[w + 1] << 63 : 0;
+
+					spread[w] = row[w] | (row[w] << 1) | previous | (row[w] >> 1) | next;
+				}
+
+				if (this->size & 63)
+				{
+					spread[this->wordsPerRow - 1] &= (std::uint64_t(1) << (this->size & 63)) - 1;
+				}
+
+				for (std::int32_t dy = glm::max(y - 1, 0); dy <= glm::min(y + 1, this->size - 1); dy++)
+				{
+					for (std::size_t w = 0; w < this->wordsPerRow; w++)
+					{
+						dilated.words[dy * this->wordsPerRow + w] |= spread[w];
+					}
+				}
+			}
+
+			return dilated;
+		}
+
+		void insert(const std::int32_t x, const std::int32_t y, const std::int32_t width, const std::uint64_t* window)
+		{
+			std::uint64_t* row = this->words.data() + y * this->wordsPerRow;
+
+			std::size_t numWords = (width + 63) / 64;
+			std::size_t first = x >> 6;
+			std::int32_t shift = x & 63;
+
+			for (std::size_t w = 0; w < numWords; w++)
+			{
+				row[first + w] |= window[w] << shift;
+
+				if (shift > 0 && first + w + 1 < this->wordsPerRow)
+				{
+					row[first + w + 1] |= window[w] >> (64 - shift);
+				}
+			}
+		}
+	};
+
+	inline Bitmap fromImage(const img::ImagePtr& image, const std::int32_t resolution, const double threshold = 0.5)
+	{
+		Bitmap bitmap(resolution);
+
+		if (!image || image->width == 0 || image->height == 0)
+		{
+			return bitmap;
+		}
+
+		std::int32_t size = bitmap.getSize();
+
+		for (std::int32_t y = 0; y < size; y++)
+		{
+			std::size_t y0 = y * image->height / size;
+			std::size_t y1 = glm::max(y0 + 1, (y + 1) * image->height / size);
+
+			for (std::int32_t x = 0; x < size; x++)
+			{
+				std::size_t x0 = x * image->width / size;
+				std::size_t x1 = glm::max(x0 + 1, (x + 1) * image->width / size);
+
+				double value = 0.0;
+
+				for (std::size_t iy = y0; iy < y1; iy++)
+				{
+					for (std::size_t ix = x0; ix < x1; ix++)
+					{
+						std::uint32_t texel = static_cast<std::uint32_t>(image->pixels[iy * image->width + ix]);
+
+						double r = (texel & 0xFF) / 255.0;
+						double g = ((texel >> 8) & 0xFF) / 255.0;
+						double b = ((texel >> 16) & 0xFF) / 255.0;
+						double a = ((texel >> 24) & 0xFF) / 255.0;
+
+						value += a * (r + g + b) / 3.0;
+					}
+				}
+
+				if (value >= threshold * double((y1 - y0) * (x1 - x0)))
+				{
+					bitmap.set(x, y);
+				}
+			}
+		}
+
+		return bitmap;
+	}
+
+	class Moments
+	{
+	private:
+		std::int32_t size;
+		std::vector<std::int64_t> counts;
+		std::vector<std::int64_t> sumsX;
+		std::vector<std::int64_t> sumsY;
+
+	public:
+		Moments(const Bitmap& bitmap) :
+			size(bitmap.getSize()), counts((size + 1) * (size + 1), 0), sumsX(counts.size(), 0), sumsY(counts.size(), 0)
+		{
+			for (std::int32_t y = 0; y < this->size; y++)
+			{
+				std::int64_t count = 0;
+				std::int64_t sumX = 0;
+
+				for (std::int32_t x = 0; x < this->size; x++)
+				{
+					if (bitmap.get(x, y))
+					{
+						count++;
+						sumX += x;
+					}
+
+					std::size_t i = (y + 1) * (this->size + 1) + x + 1;
+					std::size_t above = y * (this->size + 1) + x + 1;
+
+					this->counts[i] = this->counts[above] + count;
+					this->sumsX[i] = this->sumsX[above] + sumX;
+					this->sumsY[i] = this->sumsY[above] + count * y;
+				}
+			}
+		}
+
+		glm::dvec3 getBox(const std::int32_t x0, const std::int32_t y0, const std::int32_t x1, const std::int32_t y1) const
+		{
+			auto box = [&](const std::vector<std::int64_t>& table)
+			{
+				return double(table[y1 * (this->size + 1) + x1] - table[y0 * (this->size + 1) + x1] - table[y1 * (this->size + 1) + x0] + table[y0 * (this->size + 1) + x0]);
+			};
+
+			return glm::dvec3(box(this->counts), box(this->sumsX), box(this->sumsY));
+		}
+	};
+
+	struct Settings
+	{
+		std::int32_t resolution = 128;
+		std::int32_t maxMaps = 16;
+		std::int32_t numScales = 24;
+		float minScale = 0.1f;
+		float maxScale = 0.6f;
+		float tolerance = 0.05f;
+		float coverage = 0.97f;
+	};
+
+	struct Result
+	{
+		std::vector<ifs::Map> maps;
+
+		double coverage = 0.0;
+		double collageError = 0.0;
+
+		std::uint64_t numWindows = 0;
+		std::uint64_t numCompared = 0;
+		std::uint64_t numCandidates = 0;
+	};
+
+	inline ifs::Map transform(const ifs::Map& map, const glm::dvec4& bounds)
+	{
+		double width = bounds.y - bounds.x;
+		double height = bounds.w - bounds.z;
+
+		ifs::Map result = map;
+
+		result.b = static_cast<float>(map.b * width / height);
+		result.c = static_cast<float>(map.c * height / width);
+
+		result.e = static_cast<float>(bounds.x + width * map.e - result.a * bounds.x - result.b * bounds.z);
+		result.f = static_cast<float>(bounds.z + height * map.f - result.c * bounds.x - result.d * bounds.z);
+
+		return result;
+	}
+
+	class Encoder
+	{
+	public:
+		static constexpr std::int32_t maxCells = 64;
+
+	private:
+		struct Pattern
+		{
+			std::int32_t scale;
+			std::int32_t isometry;
+
+			Bitmap bitmap;
+			Bitmap dilated;
+
+			std::int64_t count;
+		};
+
+		struct Candidate
+		{
+			std::int32_t pattern;
+			std::int32_t x;
+			std::int32_t y;
+
+			std::int64_t outside;
+			std::int64_t score;
+
+			bool operator<(const Candidate& other) const
+			{
+				return this->score < other.score;
+			}
+		};
+
+		Bitmap target;
+		Bitmap neighbourhood;
+
+		Moments moments;
+		Moments neighbourhoodMoments;
+
+		Settings settings;
+
+		std::int32_t numThreads;
+
+		std::vector<std::int32_t> sizes;
+		std::vector<Pattern> patterns;
+
+		Pattern createPattern(const std::int32_t scale, const std::int32_t patternSize, const std::int32_t index) const
+		{
+			std::int32_t size = this->target.getSize();
+
+			const Isometry& isometry = getIsometry(index);
+
+			Pattern pattern = { scale, index, Bitmap(patternSize), Bitmap(), 0 };
+
+			double half = 0.5 * size / patternSize;
+
+			for (std::int32_t j = 0; j < patternSize; j++)
+			{
+				for (std::int32_t i = 0; i < patternSize; i++)
+				{
+					double qx = (i + 0.5) / patternSize - isometry.e;
+					double qy = (j + 0.5) / patternSize - isometry.f;
+
+					double cx = (isometry.a * qx + isometry.c * qy) * size;
+					double cy = (isometry.b * qx + isometry.d * qy) * size;
+
+					std::int32_t x0 = glm::clamp(static_cast<std::int32_t>(std::round(cx - half)), 0, size - 1);
+					std::int32_t y0 = glm::clamp(static_cast<std::int32_t>(std::round(cy - half)), 0, size - 1);
+					std::int32_t x1 = glm::clamp(static_cast<std::int32_t>(std::round(cx + half)), x0 + 1, size);
+					std::int32_t y1 = glm::clamp(static_cast<std::int32_t>(std::round(cy + half)), y0 + 1, size);
+
+					if (this->moments.getBox(x0, y0, x1, y1).x > 0.0)
+					{
+						pattern.bitmap.set(i, j);
+					}
+				}
+			}
+
+			pattern.count = static_cast<std::int64_t>(pattern.bitmap.count());
+
+			if (pattern.count == 0)
+			{
+				return pattern;
+			}
+
+			pattern.dilated = pattern.bitmap.dilate();
+
+			return pattern;
+		}
+
+		void createPatterns()
+		{
+			std::int32_t size = this->target.getSize();
+
+			for (std::int32_t s = 0; s < this->settings.numScales; s++)
+			{
+				double t = this->settings.numScales > 1 ? double(s) / (this->settings.numScales - 1) : 0.0;
+
+				double scale = this->settings.maxScale * std::pow(double(this->settings.minScale) / this->settings.maxScale, t);
+
+				std::int32_t patternSize = glm::clamp(static_cast<std::int32_t>(std::round(scale * size)), 2, size - 1);
+
+				if (std::find(this->sizes.begin(), this->sizes.end(), patternSize) == this->sizes.end())
+				{
+					this->sizes.push_back(patternSize);
+				}
+			}
+
+			for (std::int32_t s = 0; s < static_cast<std::int32_t>(this->sizes.size()); s++)
+			{
+				for (std::int32_t k = 0; k < numIsometries; k++)
+				{
+					Pattern pattern = this->createPattern(s, this->sizes[s], k);
+
+					if (pattern.count > 0)
+					{
+						this->patterns.push_back(pattern);
+					}
+				}
+			}
+		}
+
+		std::int64_t countOutside(const Bitmap& pattern, const Bitmap& image, const std::int32_t x, const std::int32_t y, const std::int64_t limit) const
+		{
+			std::uint64_t window[Bitmap::maxWords];
+
+			std::size_t numWords = pattern.getWordsPerRow();
+
+			std::int64_t outside = 0;
+
+			for (std::int32_t j = 0; j < pattern.getSize() && outside <= limit; j++)
+			{
+				const std::uint64_t* row = pattern.getRow(j);
+
+				image.extract(x, y + j, pattern.getSize(), window);
+
+				for (std::size_t w = 0; w < numWords; w++)
+				{
+					outside += ifs::countBits(row[w] & ~window[w]);
+				}
+			}
+
+			return outside;
+		}
+
+		std::int64_t countGain(const Bitmap& pattern, const Bitmap& covered, const std::int32_t x, const std::int32_t y) const
+		{
+			std::uint64_t window[Bitmap::maxWords];
+			std::uint64_t windowCovered[Bitmap::maxWords];
+
+			std::size_t numWords = pattern.getWordsPerRow();
+
+			std::int64_t gain = 0;
+
+			for (std::int32_t j = 0; j < pattern.getSize(); j++)
+			{
+				const std::uint64_t* row = pattern.getRow(j);
+
+				this->target.extract(x, y + j, pattern.getSize(), window);
+				covered.extract(x, y + j, pattern.getSize(), windowCovered);
+
+				for (std::size_t w = 0; w < numWords; w++)
+				{
+					gain += ifs::countBits(row[w] & window[w] & ~windowCovered[w]);
+				}
+			}
+
+			return gain;
+		}
+
+		std::vector<Candidate> match(std::uint64_t& numWindows, std::uint64_t& numCompared) const
+		{
+			std::int32_t size = this->target.getSize();
+
+			std::vector<std::vector<Candidate>> candidates(this->numThreads);
+			std::vector<std::uint64_t> windows(this->numThreads, 0);
+			std::vector<std::uint64_t> compared(this->numThreads, 0);
+
+			ifs::parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				for (std::size_t p = t; p < this->patterns.size(); p += this->numThreads)
+				{
+					const Pattern& pattern = this->patterns[p];
+
+					std::int32_t patternSize = pattern.bitmap.getSize();
+					std::int32_t positions = size - patternSize + 1;
+					std::int32_t cellSize = glm::max(glm::max(1, patternSize / 4), (positions + maxCells - 1) / maxCells);
+
+					std::int64_t limit = static_cast<std::int64_t>(this->settings.tolerance * pattern.count);
+
+					for (std::int32_t cy = 0; cy < positions; cy += cellSize)
+					{
+						for (std::int32_t cx = 0; cx < positions; cx += cellSize)
+						{
+							Candidate best = { static_cast<std::int32_t>(p), 0, 0, limit + 1, 0 };
+
+							double bestDensity = 0.0;
+
+							for (std::int32_t y = cy; y < glm::min(positions, cy + cellSize); y++)
+							{
+								for (std::int32_t x = cx; x < glm::min(positions, cx + cellSize); x++)
+								{
+									double density = this->neighbourhoodMoments.getBox(x, y, x + patternSize, y + patternSize).x;
+
+									if (density < double(pattern.count - limit))
+									{
+										continue;
+									}
+
+									windows[t]++;
+
+									if (best.outside == 0 && density >= bestDensity)
+									{
+										continue;
+									}
+
+									compared[t]++;
+
+									std::int64_t outside = this->countOutside(pattern.bitmap, this->neighbourhood, x, y, best.outside);
+
+									if (outside < best.outside || (outside == best.outside && density < bestDensity))
+									{
+										best = { static_cast<std::int32_t>(p), x, y, outside, pattern.count - 2 * outside };
+
+										bestDensity = density;
+									}
+								}
+							}
+
+							if (best.outside <= limit && best.outside < pattern.count)
+							{
+								candidates[t].push_back(best);
+							}
+						}
+					}
+				}
+			});
+
+			numWindows = std::accumulate(windows.begin(), windows.end(), std::uint64_t(0));
+			numCompared = std::accumulate(compared.begin(), compared.end(), std::uint64_t(0));
+
+			std::vector<Candidate> merged;
+
+			for (const auto& list : candidates)
+			{
+				merged.insert(merged.end(), list.begin(), list.end());
+			}
+
+			return merged;
+		}
+
+		ifs::Map getMap(const Pattern& pattern, const std::int32_t x, const std::int32_t y) const
+		{
+			const Isometry& isometry = getIsometry(pattern.isometry);
+
+			float scale = float(pattern.bitmap.getSize()) / this->target.getSize();
+
+			ifs::Map map;
+
+			map.a = scale * isometry.a;
+			map.b = scale * isometry.b;
+			map.c = scale * isometry.c;
+			map.d = scale * isometry.d;
+			map.e = scale * isometry.e + float(x) / this->target.getSize();
+			map.f = scale * isometry.f + float(y) / this->target.getSize();
+
+			return map;
+		}
+
+		Pattern refine(const Pattern& pattern, const Bitmap& covered, std::int32_t& x, std::int32_t& y) const
+		{
+			std::int32_t size = this->target.getSize();
+			std::int32_t patternSize = pattern.bitmap.getSize();
+			std::int32_t radius = glm::max(1, patternSize / 16);
+
+			Pattern best = pattern;
+
+			std::int64_t bestScore = this->countGain(pattern.dilated, covered, x, y) - this->countOutside(pattern.bitmap, this->target, x, y, pattern.count);
+
+			std::int32_t bestX = x;
+			std::int32_t bestY = y;
+
+			for (std::int32_t candidateSize = glm::max(2, patternSize - radius); candidateSize <= glm::min(size - 1, patternSize + radius); candidateSize++)
+			{
+				Pattern candidate = candidateSize == patternSize ? pattern : this->createPattern(pattern.scale, candidateSize, pattern.isometry);
+
+				if (candidate.count == 0)
+				{
+					continue;
+				}
+
+				std::int32_t centerX = x + (patternSize - candidateSize) / 2;
+				std::int32_t centerY = y + (patternSize - candidateSize) / 2;
+
+				for (std::int32_t cy = glm::max(0, centerY - 2); cy <= glm::min(size - candidateSize, centerY + 2); cy++)
+				{
+					for (std::int32_t cx = glm::max(0, centerX - 2); cx <= glm::min(size - candidateSize, centerX + 2); cx++)
+					{
+						std::int64_t outside = this->countOutside(candidate.bitmap, this->neighbourhood, cx, cy, static_cast<std::int64_t>(this->settings.tolerance * candidate.count));
+
+						if (outside > this->settings.tolerance * candidate.count)
+						{
+							continue;
+						}
+
+						std::int64_t score = this->countGain(candidate.dilated, covered, cx, cy) - this->countOutside(candidate.bitmap, this->target, cx, cy, candidate.count);
+
+						if (score > bestScore)
+						{
+							best = candidate;
+							bestScore = score;
+							bestX = cx;
+							bestY = cy;
+						}
+					}
+				}
+			}
+
+			x = bestX;
+			y = bestY;
+
+			return best;
+		}
+
+	public:
+		Encoder(const Bitmap& target, const Settings& settings = Settings(), const std::int32_t numThreads = 0) :
+			target(target), neighbourhood(target.dilate()), moments(target), neighbourhoodMoments(this->neighbourhood), settings(settings)
+		{
+			this->numThreads = numThreads > 0 ? numThreads : glm::max(1, static_cast<std::int32_t>(std::thread::hardware_concurrency()));
+
+			if (this->target.getSize() < 8)
+			{
+				throw std::runtime_error("IFS-Error: Collage target is too small.");
+			}
+
+			this->settings.minScale = glm::clamp(this->settings.minScale, 0.01f, 0.95f);
+			this->settings.maxScale = glm::clamp(this->settings.maxScale, this->settings.minScale, 0.95f);
+			this->settings.numScales = glm::max(this->settings.numScales, 1);
+
+			this->createPatterns();
+		}
+
+		Result encode() const
+		{
+			Result result;
+
+			std::int64_t total = static_cast<std::int64_t>(this->target.count());
+
+			if (total == 0)
+			{
+				return result;
+			}
+
+			std::vector<Candidate> candidates = this->match(result.numWindows, result.numCompared);
+
+			result.numCandidates = candidates.size();
+
+			std::priority_queue<Candidate> queue(std::less<Candidate>(), std::move(candidates));
+
+			Bitmap covered(this->target.getSize());
+			Bitmap placed(this->target.getSize());
+
+			std::int64_t numCovered = 0;
+			std::int64_t minGain = glm::max(std::int64_t(1), total / 500);
+
+			while (!queue.empty() && static_cast<std::int32_t>(result.maps.size()) < this->settings.maxMaps && numCovered < this->settings.coverage * total)
+			{
+				Candidate candidate = queue.top();
+
+				queue.pop();
+
+				const Pattern& pattern = this->patterns[candidate.pattern];
+
+				std::int64_t gain = this->countGain(pattern.dilated, covered, candidate.x, candidate.y);
+
+				candidate.score = gain - candidate.outside;
+
+				if (gain < minGain || candidate.score <= 0)
+				{
+					continue;
+				}
+
+				if (!queue.empty() && candidate.score < queue.top().score)
+				{
+					queue.push(candidate);
+
+					continue;
+				}
+
+				Pattern refined = this->refine(pattern, covered, candidate.x, candidate.y);
+
+				numCovered += this->countGain(refined.dilated, covered, candidate.x, candidate.y);
+
+				for (std::int32_t j = 0; j < refined.bitmap.getSize(); j++)
+				{
+					covered.insert(candidate.x, candidate.y + j, refined.bitmap.getSize(), refined.dilated.getRow(j));
+					placed.insert(candidate.x, candidate.y + j, refined.bitmap.getSize(), refined.bitmap.getRow(j));
+				}
+
+				result.maps.push_back(this->getMap(refined, candidate.x, candidate.y));
+			}
+
+			std::int64_t difference = 0;
+
+			for (std::int32_t y = 0; y < this->target.getSize(); y++)
+			{
+				for (std::size_t w = 0; w < this->target.getWordsPerRow(); w++)
+				{
+					difference += ifs::countBits(this->target.getRow(y)[w] & ~covered.getRow(y)[w]);
+					difference += ifs::countBits(placed.getRow(y)[w] & ~this->neighbourhood.getRow(y)[w]);
+				}
+			}
+
+			result.coverage = double(numCovered) / total;
+			result.collageError = double(difference) / total;
+
+			return result;
+		}
+
+		std::size_t getNumPatterns() const
+		{
+			return this->patterns.size();
+		}
+
+		std::int32_t getNumThreads() const
+		{
+			return this->numThreads;
+		}
+	};
+}
@@ -0,0 +1,1581 @@
+#pragma once
+
+#include "OpenGLHelper.hpp"
+
+namespace formula
+{
+	struct Variable
+	{
+		Variable(const std::string& name = "", const bool real = false) :
+			name(name), real(real)
+		{
+
+		}
+
+		std::string name;
+		bool real;
+	};
+
+	enum class Operation : int
+	{
+		Constant,
+		Variable,
+		Add,
+		Subtract,
+		Multiply,
+		Divide,
+		Negate,
+		Square,
+		Power,
+		Sin,
+		Cos,
+		Tan,
+		Exp,
+		Log,
+		Sqrt,
+		Abs,
+		Re,
+		Im,
+		Conj,
+		Norm,
+		Arg,
+		Floor,
+		Min,
+		Max,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		Equal,
+		NotEqual,
+		And,
+		Or,
+		Not,
+		Select,
+	};
+
+	struct Node;
+
+	typedef std::shared_ptr<Node> NodePtr;
+
+	struct Node
+	{
+		Operation operation = Operation::Constant;
+		glm::dvec2 value = glm::dvec2(0.0);
+		std::int32_t variable = -1;
+		std::vector<NodePtr> operands;
+		bool real = true;
+		std::size_t id = 0;
+
+		bool isConstant() const
+		{
+			return this->operation == Operation::Constant;
+		}
+
+		bool isConstant(const double value) const
+		{
+			return this->isConstant() && this->value == glm::dvec2(value, 0.0);
+		}
+	};
+
+	namespace detail
+	{
+		inline glm::dvec2 multiply(const glm::dvec2& a, const glm::dvec2& b)
+		{
+			return glm::dvec2(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x);
+		}
+
+		inline glm::dvec2 divide(const glm::dvec2& a, const glm::dvec2& b)
+		{
+			return glm::dvec2(a.x * b.x + a.y * b.y, a.y * b.x - a.x * b.y) / glm::dot(b, b);
+		}
+
+		inline glm::dvec2 exp(const glm::dvec2& a)
+		{
+			return std::exp(a.x) * glm::dvec2(std::cos(a.y), std::sin(a.y));
+		}
+
+		inline glm::dvec2 log(const glm::dvec2& a)
+		{
+			return glm::dvec2(std::log(glm::length(a)), std::atan2(a.y, a.x));
+		}
+
+		inline glm::dvec2 sin(const glm::dvec2& a)
+		{
+			return glm::dvec2(std::sin(a.x) * std::cosh(a.y), std::cos(a.x) * std::sinh(a.y));
+		}
+
+		inline glm::dvec2 cos(const glm::dvec2& a)
+		{
+			return glm::dvec2(std::cos(a.x) * std::cosh(a.y), -std::sin(a.x) * std::sinh(a.y));
+		}
+
+		inline glm::dvec2 sqrt(const glm::dvec2& a)
+		{
+			double r = glm::length(a);
+
+			return glm::dvec2(std::sqrt((r + a.x) / 2.0), (a.y < 0.0 ? -1.0 : 1.0) * std::sqrt(glm::max(0.0, (r - a.x) / 2.0)));
+		}
+
+		inline glm::dvec2 power(const glm::dvec2& a, const glm::dvec2& b)
+		{
+			return a == glm::dvec2(0.0) ? glm::dvec2(0.0) : exp(multiply(b, log(a)));
+		}
+
+		inline glm::dvec2 evaluate(const Operation operation, const std::vector<glm::dvec2>& operands, const bool real)
+		{
+			auto a = operands.size() > 0 ? operands[0] : glm::dvec2(0.0);
+			auto b = operands.size() > 1 ? operands[1] : glm::dvec2(0.0);
+			auto c = operands.size() > 2 ? operands[2] : glm::dvec2(0.0);
+
+			auto r = [](const double value) { return glm::dvec2(value, 0.0); };
+
+			switch (operation)
+			{
+			case Operation::Add: return a + b;
+			case Operation::Subtract: return a - b;
+			case Operation::Multiply: return multiply(a, b);
+			case Operation::Divide: return real ? r(a.x / b.x) : divide(a, b);
+			case Operation::Negate: return real ? r(-a.x) : -a;
+			case Operation::Square: return multiply(a, a);
+			case Operation::Power: return real ? r(std::pow(a.x, b.x)) : power(a, b);
+			case Operation::Sin: return real ? r(std::sin(a.x)) : sin(a);
+			case Operation::Cos: return real ? r(std::cos(a.x)) : cos(a);
+			case Operation::Tan: return real ? r(std::tan(a.x)) : divide(sin(a), cos(a));
+			case Operation::Exp: return real ? r(std::exp(a.x)) : exp(a);
+			case Operation::Log: return real ? r(std::log(a.x)) : log(a);
+			case Operation::Sqrt: return real ? r(std::sqrt(a.x)) : sqrt(a);
+			case Operation::Abs: return r(glm::length(a));
+			case Operation::Re: return r(a.x);
+			case Operation::Im: return r(a.y);
+			case Operation::Conj: return glm::dvec2(a.x, -a.y);
+			case Operation::Norm: return r(glm::dot(a, a));
+			case Operation::Arg: return r(std::atan2(a.y, a.x));
+			case Operation::Floor: return r(std::floor(a.x));
+			case Operation::Min: return r(glm::min(a.x, b.x));
+			case Operation::Max: return r(glm::max(a.x, b.x));
+			case Operation::Less: return r(a.x < b.x);
+			case Operation::LessEqual: return r(a.x <= b.x);
+			case Operation::Greater: return r(a.x > b.x);
+			case Operation::GreaterEqual: return r(a.x >= b.x);
+			case Operation::Equal: return r(a.x == b.x);
+			case Operation::NotEqual: return r(a.x != b.x);
+			case Operation::And: return r(a.x != 0.0 && b.x != 0.0);
+			case Operation::Or: return r(a.x != 0.0 || b.x != 0.0);
+			case Operation::Not: return r(a.x == 0.0);
+			case Operation::Select: return a.x != 0.0 ? b : c;
+			default: return a;
+			}
+		}
+	}
+
+	class Builder
+	{
+	private:
+		std::map<std::string, NodePtr> nodes;
+
+		NodePtr intern(const std::shared_ptr<Node>& node)
+		{
+			std::stringstream stream;
+
+			stream << std::hexfloat << static_cast<int>(node->operation) << ":" << node->value.x << ":" << node->value.y << ":" << node->variable;
+
+			for (const auto& operand : node->operands)
+			{
+				stream << ":" << operand->id;
+			}
+
+			auto& interned = this->nodes[stream.str()];
+
+			if (!interned)
+			{
+				node->id = this->nodes.size();
+
+				interned = node;
+			}
+
+			return interned;
+		}
+
+		static bool isInteger(const NodePtr& node, const double limit)
+		{
+			return node->isConstant() && node->value.y == 0.0 && std::floor(node->value.x) == node->value.x && std::abs(node->value.x) <= limit;
+		}
+
+		static bool isNonNegative(const NodePtr& node)
+		{
+			if (!node->real)
+			{
+				return false;
+			}
+
+			switch (node->operation)
+			{
+			case Operation::Constant: return node->value.x >= 0.0;
+			case Operation::Square:
+			case Operation::Exp:
+			case Operation::Sqrt:
+			case Operation::Abs:
+			case Operation::Norm:
+			case Operation::Less:
+			case Operation::LessEqual:
+			case Operation::Greater:
+			case Operation::GreaterEqual:
+			case Operation::Equal:
+			case Operation::NotEqual:
+			case Operation::And:
+			case Operation::Or:
+			case Operation::Not: return true;
+			case Operation::Add:
+			case Operation::Multiply:
+			case Operation::Divide:
+			case Operation::Min: return isNonNegative(node->operands[0]) && isNonNegative(node->operands[1]);
+			case Operation::Max: return isNonNegative(node->operands[0]) || isNonNegative(node->operands[1]);
+			case Operation::Power: return isNonNegative(node->operands[0]);
+			case Operation::Select: return isNonNegative(node->operands[1]) && isNonNegative(node->operands[2]);
+			default: return false;
+			}
+		}
+
+	public:
+		NodePtr constant(const glm::dvec2& value)
+		{
+			auto node = std::make_shared<Node>();
+
+			node->operation = Operation::Constant;
+			node->value = value;
+			node->real = value.y == 0.0;
+
+			return this->intern(node);
+		}
+
+		NodePtr constant(const double value)
+		{
+			return this->constant(glm::dvec2(value, 0.0));
+		}
+
+		NodePtr variable(const std::int32_t index, const bool real)
+		{
+			auto node = std::make_shared<Node>();
+
+			node->operation = Operation::Variable;
+			node->variable = index;
+			node->real = real;
+
+			return this->intern(node);
+		}
+
+		NodePtr make(const Operation operation, const std::vector<NodePtr>& operands)
+		{
+			bool constant = true;
+			bool real = true;
+
+			for (const auto& operand : operands)
+			{
+				constant &= operand->isConstant();
+				real &= operand->real;
+			}
+
+			switch (operation)
+			{
+			case Operation::Abs:
+			case Operation::Re:
+			case Operation::Im:
+			case Operation::Norm:
+			case Operation::Arg:
+			case Operation::Floor:
+			case Operation::Min:
+			case Operation::Max:
+			case Operation::Less:
+			case Operation::LessEqual:
+			case Operation::Greater:
+			case Operation::GreaterEqual:
+			case Operation::Equal:
+			case Operation::NotEqual:
+			case Operation::And:
+			case Operation::Or:
+			case Operation::Not:
+			{
+				real = true;
+
+				break;
+			}
+			case Operation::Select:
+			{
+				real = operands[1]->real && operands[2]->real;
+
+				break;
+			}
+			case Operation::Log:
+			case Operation::Sqrt:
+			{
+				real &= this->isNonNegative(operands[0]);
+
+				break;
+			}
+			case Operation::Power:
+			{
+				real &= this->isNonNegative(operands[0]) || this->isInteger(operands[1], std::ldexp(1.0, 53));
+
+				break;
+			}
+			default:
+			{
+				break;
+			}
+			}
+
+			if (constant)
+			{
+				std::vector<glm::dvec2> values;
+
+				for (const auto& operand : operands)
+				{
+					values.push_back(operand->value);
+				}
+
+				return this->constant(detail::evaluate(operation, values, real));
+			}
+
+			const auto& a = operands[0];
+			const auto& b = operands.size() > 1 ? operands[1] : operands[0];
+
+			switch (operation)
+			{
+			case Operation::Add:
+			{
+				if (a->isConstant(0.0)) return b;
+				if (b->isConstant(0.0)) return a;
+				if (b->operation == Operation::Negate) return this->make(Operation::Subtract, { a, b->operands[0] });
+
+				break;
+			}
+			case Operation::Subtract:
+			{
+				if (b->isConstant(0.0)) return a;
+				if (a->isConstant(0.0)) return this->make(Operation::Negate, { b });
+				if (a == b) return this->constant(0.0);
+
+				break;
+			}
+			case Operation::Multiply:
+			{
+				if (a->isConstant(1.0)) return b;
+				if (b->isConstant(1.0)) return a;
+				if (a->isConstant(0.0) || b->isConstant(0.0)) return this->constant(0.0);
+				if (a->isConstant(-1.0)) return this->make(Operation::Negate, { b });
+				if (b->isConstant(-1.0)) return this->make(Operation::Negate, { a });
+				if (a == b) return this->make(Operation::Square, { a });
+
+				break;
+			}
+			case Operation::Divide:
+			{
+				if (b->isConstant(1.0)) return a;
+				if (b->isConstant() && b->value != glm::dvec2(0.0)) return this->make(Operation::Multiply, { a, this->constant(detail::divide(glm::dvec2(1.0, 0.0), b->value)) });
+
+				break;
+			}
+			case Operation::Negate:
+			{
+				if (a->operation == Operation::Negate) return a->operands[0];
+
+				break;
+			}
+			case Operation::Power:
+			{
+				if (this->isInteger(b, 256.0))
+				{
+					std::int32_t exponent = static_cast<std::int32_t>(b->value.x);
+
+					if (exponent < 0)
+					{
+						return this->make(Operation::Divide, { this->constant(1.0), this->make(Operation::Power, { a, this->constant(-exponent) }) });
+					}
+
+					NodePtr result = this->constant(1.0);
+					NodePtr base = a;
+
+					for (; exponent > 0; exponent >>= 1)
+					{
+						if (exponent & 1)
+						{
+							result = this->make(Operation::Multiply, { result, base });
+						}
+
+						if (exponent > 1)
+						{
+							base = this->make(Operation::Square, { base });
+						}
+					}
+
+					return result;
+				}
+
+				if (b->isConstant(0.5)) return this->make(Operation::Sqrt, { a });
+
+				break;
+			}
+			case Operation::Abs:
+			{
+				if (a->operation == Operation::Abs || a->operation == Operation::Norm) return a;
+
+				break;
+			}
+			case Operation::Re:
+			case Operation::Conj:
+			{
+				if (a->real) return a;
+
+				break;
+			}
+			case Operation::Im:
+			{
+				if (a->real) return this->constant(0.0);
+
+				break;
+			}
+			case Operation::Select:
+			{
+				if (a->isConstant()) return a->value.x != 0.0 ? operands[1] : operands[2];
+				if (operands[1] == operands[2]) return operands[1];
+
+				break;
+			}
+			default:
+			{
+				break;
+			}
+			}
+
+			auto node = std::make_shared<Node>();
+
+			node->operation = operation;
+			node->operands = operands;
+			node->real = real;
+
+			return this->intern(node);
+		}
+	};
+
+	class Parser
+	{
+	private:
+		std::string source;
+		std::size_t position;
+
+		std::vector<Variable> variables;
+
+		Builder& builder;
+
+		void skipWhitespace()
+		{
+			while (this->position < this->source.size() && std::isspace(static_cast<unsigned char>(this->source[this->position])))
+			{
+				this->position++;
+			}
+		}
+
+		bool accept(const std::string& token)
+		{
+			this->skipWhitespace();
+
+			if (this->source.compare(this->position, token.size(), token) == 0)
+			{
+				this->position += token.size();
+
+				return true;
+			}
+
+			return false;
+		}
+
+		void expect(const std::string& token)
+		{
+			if (!this->accept(token))
+			{
+				this->fail("Expected '" + token + "'");
+			}
+		}
+
+		void fail(const std::string& message) const
+		{
+			std::stringstream stream;
+
+			stream << "Formula-Error: " << message << " at position " << this->position << ".";
+
+			throw std::runtime_error(stream.str());
+		}
+
+		NodePtr parseTernary()
+		{
+			auto condition = this->parseOr();
+
+			if (this->accept("?"))
+			{
+				auto a = this->parseTernary();
+
+				this->expect(":");
+
+				auto b = this->parseTernary();
+
+				return this->builder.make(Operation::Select, { condition, a, b });
+			}
+
+			return condition;
+		}
+
+		NodePtr parseOr()
+		{
+			auto node = this->parseAnd();
+
+			while (this->accept("||"))
+			{
+				node = this->builder.make(Operation::Or, { node, this->parseAnd() });
+			}
+
+			return node;
+		}
+
+		NodePtr parseAnd()
+		{
+			auto node = this->parseComparison();
+
+			while (this->accept("&&"))
+			{
+				node = this->builder.make(Operation::And, { node, this->parseComparison() });
+			}
+
+			return node;
+		}
+
+		NodePtr parseComparison()
+		{
+			static const std::vector<std::pair<std::string, Operation>> operators = {
+				{ "<=", Operation::LessEqual },
+				{ ">=", Operation::GreaterEqual },
+				{ "==", Operation::Equal },
+				{ "!=", Operation::NotEqual },
+				{ "<", Operation::Less },
+				{ ">", Operation::Greater },
+			};
+
+			auto node = this->parseAdditive();
+
+			for (bool found = true; found; )
+			{
+				found = false;
+
+				for (const auto& op : operators)
+				{
+					if (this->accept(op.first))
+					{
+						node = this->builder.make(op.second, { node, this->parseAdditive() });
+
+						found = true;
+
+						break;
+					}
+				}
+			}
+
+			return node;
+		}
+
+		NodePtr parseAdditive()
+		{
+			auto node = this->parseMultiplicative();
+
+			while (true)
+			{
+				if (this->accept("+"))
+				{
+					node = this->builder.make(Operation::Add, { node, this->parseMultiplicative() });
+				}
+				else if (this->accept("-"))
+				{
+					node = this->builder.make(Operation::Subtract, { node, this->parseMultiplicative() });
+				}
+				else
+				{
+					return node;
+				}
+			}
+		}
+
+		NodePtr parseMultiplicative()
+		{
+			auto node = this->parseUnary();
+
+			while (true)
+			{
+				if (this->accept("*"))
+				{
+					node = this->builder.make(Operation::Multiply, { node, this->parseUnary() });
+				}
+				else if (this->accept("/"))
+				{
+					node = this->builder.make(Operation::Divide, { node, this->parseUnary() });
+				}
+				else
+				{
+					return node;
+				}
+			}
+		}
+
+		NodePtr parseUnary()
+		{
+			if (this->accept("-"))
+			{
+				return this->builder.make(Operation::Negate, { this->parseUnary() });
+			}
+
+			if (this->accept("+"))
+			{
+				return this->parseUnary();
+			}
+
+			if (this->accept("!") )
+			{
+				return this->builder.make(Operation::Not, { this->parseUnary() });
+			}
+
+			return this->parsePower();
+		}
+
+		NodePtr parsePower()
+		{
+			auto node = this->parsePrimary();
+
+			if (this->accept("^"))
+			{
+				return this->builder.make(Operation::Power, { node, this->parseUnary() });
+			}
+
+			return node;
+		}
+
+		NodePtr parsePrimary()
+		{
+			this->skipWhitespace();
+
+			if (this->position >= this->source.size())
+			{
+				this->fail("Unexpected end of formula");
+			}
+
+			char character = this->source[this->position];
+
+			if (std::isdigit(static_cast<unsigned char>(character)) || character == '.')
+			{
+				const char* begin = this->source.c_str() + this->position;
+				char* end = nullptr;
+
+				double value = std::strtod(begin, &end);
+
+				if (end == begin)
+				{
+					this->fail("Invalid number");
+				}
+
+				this->position += end - begin;
+
+				this->accept("f");
+
+				return this->builder.constant(value);
+			}
+
+			if (std::isalpha(static_cast<unsigned char>(character)) || character == '_')
+			{
+				std::size_t begin = this->position;
+
+				while (this->position < this->source.size() && (std::isalnum(static_cast<unsigned char>(this->source[this->position])) || this->source[this->position] == '_'))
+				{
+					this->position++;
+				}
+
+				std::string name = this->source.substr(begin, this->position - begin);
+
+				if (this->accept("("))
+				{
+					return this->parseFunction(name);
+				}
+
+				for (std::size_t i = 0; i < this->variables.size(); i++)
+				{
+					if (this->variables[i].name == name)
+					{
+						return this->builder.variable(static_cast<std::int32_t>(i), this->variables[i].real);
+					}
+				}
+
+				if (name == "pi")
+				{
+					return this->builder.constant(3.14159265358979323846);
+				}
+				else if (name == "e")
+				{
+					return this->builder.constant(2.71828182845904523536);
+				}
+				else if (name == "i")
+				{
+					return this->builder.constant(glm::dvec2(0.0, 1.0));
+				}
+
+				this->position = begin;
+
+				this->fail("Unknown identifier '" + name + "'");
+			}
+
+			if (this->accept("("))
+			{
+				auto node = this->parseTernary();
+
+				this->expect(")");
+
+				return node;
+			}
+
+			this->fail(std::string("Unexpected character '") + character + "'");
+
+			return nullptr;
+		}
+
+		NodePtr parseFunction(const std::string& name)
+		{
+			static const std::map<std::string, std::pair<Operation, std::size_t>> functions = {
+				{ "sin", { Operation::Sin, 1 } },
+				{ "cos", { Operation::Cos, 1 } },
+				{ "tan", { Operation::Tan, 1 } },
+				{ "exp", { Operation::Exp, 1 } },
+				{ "log", { Operation::Log, 1 } },
+				{ "sqrt", { Operation::Sqrt, 1 } },
+				{ "abs", { Operation::Abs, 1 } },
+				{ "re", { Operation::Re, 1 } },
+				{ "im", { Operation::Im, 1 } },
+				{ "conj", { Operation::Conj, 1 } },
+				{ "norm", { Operation::Norm, 1 } },
+				{ "arg", { Operation::Arg, 1 } },
+				{ "floor", { Operation::Floor, 1 } },
+				{ "min", { Operation::Min, 2 } },
+				{ "max", { Operation::Max, 2 } },
+				{ "pow", { Operation::Power, 2 } },
+			};
+
+			auto function = functions.find(name);
+
+			if (function == functions.end())
+			{
+				this->fail("Unknown function '" + name + "'");
+			}
+
+			std::vector<NodePtr> operands;
+
+			if (!this->accept(")"))
+			{
+				do
+				{
+					operands.push_back(this->parseTernary());
+				}
+				while (this->accept(","));
+
+				this->expect(")");
+			}
+
+			if (operands.size() != function->second.second)
+			{
+				this->fail("Function '" + name + "' expects " + std::to_string(function->second.second) + " argument(s)");
+			}
+
+			return this->builder.make(function->second.first, operands);
+		}
+
+	public:
+		Parser(const std::string& source, const std::vector<Variable>& variables, Builder& builder) :
+			source(source), position(0), variables(variables), builder(builder)
+		{
+
+		}
+
+		NodePtr parse()
+		{
+			auto node = this->parseTernary();
+
+			this->skipWhitespace();
+
+			if (this->position != this->source.size())
+			{
+				this->fail("Unexpected trailing input");
+			}
+
+			return node;
+		}
+	};
+
+	enum class Opcode : int
+	{
+		Add,
+		AddReal,
+		Subtract,
+		SubtractReal,
+		Multiply,
+		MultiplyRealComplex,
+		MultiplyReal,
+		Divide,
+		DivideComplexReal,
+		DivideReal,
+		Negate,
+		NegateReal,
+		Square,
+		SquareReal,
+		Power,
+		PowerReal,
+		Sin,
+		SinReal,
+		Cos,
+		CosReal,
+		Tan,
+		TanReal,
+		Exp,
+		ExpReal,
+		Log,
+		LogReal,
+		Sqrt,
+		SqrtReal,
+		Abs,
+		AbsReal,
+		Re,
+		Im,
+		Conj,
+		Norm,
+		Arg,
+		Floor,
+		Min,
+		Max,
+		Less,
+		LessEqual,
+		Greater,
+		GreaterEqual,
+		Equal,
+		NotEqual,
+		And,
+		Or,
+		Not,
+		Select,
+	};
+
+	struct Instruction
+	{
+		Opcode opcode;
+		std::int32_t target;
+		std::int32_t a;
+		std::int32_t b;
+		std::int32_t c;
+	};
+
+	class Program
+	{
+	public:
+		static constexpr std::size_t lanes = 16;
+
+	private:
+		std::int32_t numVariables;
+		std::int32_t numRegisters;
+		std::int32_t result;
+
+		std::vector<std::pair<std::int32_t, glm::dvec2>> constants;
+		std::vector<Instruction> instructions;
+
+		struct alignas(64) Register
+		{
+			double re[lanes];
+			double im[lanes];
+		};
+
+		void prepare(std::vector<Register>& registers) const
+		{
+			registers.resize(this->numRegisters);
+
+			for (const auto& constant : this->constants)
+			{
+				std::fill(registers[constant.first].re, registers[constant.first].re + lanes, constant.second.x);
+				std::fill(registers[constant.first].im, registers[constant.first].im + lanes, constant.second.y);
+			}
+		}
+
+		void execute(std::vector<Register>& registers) const
+		{
+			for (const auto& instruction : this->instructions)
+			{
+				auto& t = registers[instruction.target];
+				const auto& a = registers[instruction.a];
+				const auto& b = registers[instruction.b];
+				const auto& c = registers[instruction.c];
+
+				double re[lanes];
+				double im[lanes];
+
+				switch (instruction.opcode)
+				{
+				case Opcode::Add:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] + b.re[i]; im[i] = a.im[i] + b.im[i]; }
+					break;
+				case Opcode::AddReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] + b.re[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Subtract:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] - b.re[i]; im[i] = a.im[i] - b.im[i]; }
+					break;
+				case Opcode::SubtractReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] - b.re[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Multiply:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] * b.re[i] - a.im[i] * b.im[i]; im[i] = a.re[i] * b.im[i] + a.im[i] * b.re[i]; }
+					break;
+				case Opcode::MultiplyRealComplex:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] * b.re[i]; im[i] = a.re[i] * b.im[i]; }
+					break;
+				case Opcode::MultiplyReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] * b.re[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Divide:
+					for (std::size_t i = 0; i < lanes; i++) { double d = b.re[i] * b.re[i] + b.im[i] * b.im[i]; re[i] = (a.re[i] * b.re[i] + a.im[i] * b.im[i]) / d; im[i] = (a.im[i] * b.re[i] - a.re[i] * b.im[i]) / d; }
+					break;
+				case Opcode::DivideComplexReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] / b.re[i]; im[i] = a.im[i] / b.re[i]; }
+					break;
+				case Opcode::DivideReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] / b.re[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Negate:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = -a.re[i]; im[i] = -a.im[i]; }
+					break;
+				case Opcode::NegateReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = -a.re[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Square:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] * a.re[i] - a.im[i] * a.im[i]; im[i] = 2.0 * a.re[i] * a.im[i]; }
+					break;
+				case Opcode::SquareReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] * a.re[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Power:
+					for (std::size_t i = 0; i < lanes; i++) { auto v = detail::power(glm::dvec2(a.re[i], a.im[i]), glm::dvec2(b.re[i], b.im[i])); re[i] = v.x; im[i] = v.y; }
+					break;
+				case Opcode::PowerReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::pow(a.re[i], b.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Sin:
+					for (std::size_t i = 0; i < lanes; i++) { auto v = detail::sin(glm::dvec2(a.re[i], a.im[i])); re[i] = v.x; im[i] = v.y; }
+					break;
+				case Opcode::SinReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::sin(a.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Cos:
+					for (std::size_t i = 0; i < lanes; i++) { auto v = detail::cos(glm::dvec2(a.re[i], a.im[i])); re[i] = v.x; im[i] = v.y; }
+					break;
+				case Opcode::CosReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::cos(a.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Tan:
+					for (std::size_t i = 0; i < lanes; i++) { auto v = detail::divide(detail::sin(glm::dvec2(a.re[i], a.im[i])), detail::cos(glm::dvec2(a.re[i], a.im[i]))); re[i] = v.x; im[i] = v.y; }
+					break;
+				case Opcode::TanReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::tan(a.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Exp:
+					for (std::size_t i = 0; i < lanes; i++) { auto v = detail::exp(glm::dvec2(a.re[i], a.im[i])); re[i] = v.x; im[i] = v.y; }
+					break;
+				case Opcode::ExpReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::exp(a.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Log:
+					for (std::size_t i = 0; i < lanes; i++) { auto v = detail::log(glm::dvec2(a.re[i], a.im[i])); re[i] = v.x; im[i] = v.y; }
+					break;
+				case Opcode::LogReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::log(a.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Sqrt:
+					for (std::size_t i = 0; i < lanes; i++) { auto v = detail::sqrt(glm::dvec2(a.re[i], a.im[i])); re[i] = v.x; im[i] = v.y; }
+					break;
+				case Opcode::SqrtReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::sqrt(a.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Abs:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::sqrt(a.re[i] * a.re[i] + a.im[i] * a.im[i]); im[i] = 0.0; }
+					break;
+				case Opcode::AbsReal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::abs(a.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Re:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Im:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.im[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Conj:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i]; im[i] = -a.im[i]; }
+					break;
+				case Opcode::Norm:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] * a.re[i] + a.im[i] * a.im[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Arg:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::atan2(a.im[i], a.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Floor:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = std::floor(a.re[i]); im[i] = 0.0; }
+					break;
+				case Opcode::Min:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = b.re[i] < a.re[i] ? b.re[i] : a.re[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Max:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] < b.re[i] ? b.re[i] : a.re[i]; im[i] = 0.0; }
+					break;
+				case Opcode::Less:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] < b.re[i] ? 1.0 : 0.0; im[i] = 0.0; }
+					break;
+				case Opcode::LessEqual:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] <= b.re[i] ? 1.0 : 0.0; im[i] = 0.0; }
+					break;
+				case Opcode::Greater:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] > b.re[i] ? 1.0 : 0.0; im[i] = 0.0; }
+					break;
+				case Opcode::GreaterEqual:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] >= b.re[i] ? 1.0 : 0.0; im[i] = 0.0; }
+					break;
+				case Opcode::Equal:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] == b.re[i] ? 1.0 : 0.0; im[i] = 0.0; }
+					break;
+				case Opcode::NotEqual:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] != b.re[i] ? 1.0 : 0.0; im[i] = 0.0; }
+					break;
+				case Opcode::And:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] != 0.0 && b.re[i] != 0.0 ? 1.0 : 0.0; im[i] = 0.0; }
+					break;
+				case Opcode::Or:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] != 0.0 || b.re[i] != 0.0 ? 1.0 : 0.0; im[i] = 0.0; }
+					break;
+				case Opcode::Not:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] == 0.0 ? 1.0 : 0.0; im[i] = 0.0; }
+					break;
+				case Opcode::Select:
+					for (std::size_t i = 0; i < lanes; i++) { re[i] = a.re[i] != 0.0 ? b.re[i] : c.re[i]; im[i] = a.re[i] != 0.0 ? b.im[i] : c.im[i]; }
+					break;
+				}
+
+				std::copy(re, re + lanes, t.re);
+				std::copy(im, im + lanes, t.im);
+			}
+		}
+
+	public:
+		Program(const std::int32_t numVariables = 0, const std::int32_t numRegisters = 1, const std::int32_t result = 0, const std::vector<std::pair<std::int32_t, glm::dvec2>>& constants = { }, const std::vector<Instruction>& instructions = { }) :
+			numVariables(numVariables), numRegisters(numRegisters), result(result), constants(constants), instructions(instructions)
+		{
+
+		}
+
+		std::size_t getNumInstructions() const
+		{
+			return this->instructions.size();
+		}
+
+		void evaluate(const std::vector<const double*>& re, const std::vector<const double*>& im, const std::size_t count, double* resultRe, double* resultIm) const
+		{
+			std::vector<Register> registers;
+
+			this->prepare(registers);
+
+			for (std::size_t begin = 0; begin < count; begin += lanes)
+			{
+				std::size_t n = glm::min(lanes, count - begin);
+
+				for (std::int32_t v = 0; v < this->numVariables; v++)
+				{
+					std::fill(registers[v].re, registers[v].re + lanes, 0.0);
+					std::fill(registers[v].im, registers[v].im + lanes, 0.0);
+
+					std::copy(re[v] + begin, re[v] + begin + n, registers[v].re);
+
+					if (im[v])
+					{
+						std::copy(im[v] + begin, im[v] + begin + n, registers[v].im);
+					}
+				}
+
+				this->execute(registers);
+
+				std::copy(registers[this->result].re, registers[this->result].re + n, resultRe + begin);
+
+				if (resultIm)
+				{
+					std::copy(registers[this->result].im, registers[this->result].im + n, resultIm + begin);
+				}
+			}
+		}
+
+		void escape(const double* zRe, const double* zIm, const double* cRe, const double* cIm, const std::size_t count, const std::uint32_t maxIterations, const double bound, std::uint32_t* iterations) const
+		{
+			std::vector<Register> registers;
+
+			this->prepare(registers);
+
+			for (std::size_t begin = 0; begin < count; begin += lanes)
+			{
+				std::size_t n = glm::min(lanes, count - begin);
+
+				std::uint32_t counts[lanes] = { };
+				bool active[lanes] = { };
+
+				for (std::size_t i = 0; i < lanes; i++)
+				{
+					std::size_t j = begin + glm::min(i, n - 1);
+
+					registers[0].re[i] = zRe[j];
+					registers[0].im[i] = zIm[j];
+					registers[1].re[i] = cRe[j];
+					registers[1].im[i] = cIm[j];
+
+					active[i] = i < n;
+				}
+
+				for (std::uint32_t iteration = 0; iteration < maxIterations; iteration++)
+				{
+					this->execute(registers);
+
+					const auto& z = registers[this->result];
+
+					bool any = false;
+
+					for (std::size_t i = 0; i < lanes; i++)
+					{
+						registers[0].re[i] = active[i] ? z.re[i] : registers[0].re[i];
+						registers[0].im[i] = active[i] ? z.im[i] : registers[0].im[i];
+
+						counts[i] += active[i];
+
+						active[i] = active[i] && z.re[i] * z.re[i] + z.im[i] * z.im[i] <= bound * bound;
+
+						any |= active[i];
+					}
+
+					if (!any)
+					{
+						break;
+					}
+				}
+
+				std::copy(counts, counts + n, iterations + begin);
+			}
+		}
+	};
+
+	class Expression
+	{
+	private:
+		std::vector<Variable> variables;
+
+		Builder builder;
+		NodePtr root;
+
+		std::vector<NodePtr> getSchedule() const
+		{
+			std::vector<NodePtr> schedule;
+			std::set<std::size_t> visited;
+
+			std::function<void(const NodePtr&)> visit = [&](const NodePtr& node)
+			{
+				if (visited.count(node->id) > 0)
+				{
+					return;
+				}
+
+				visited.insert(node->id);
+
+				for (const auto& operand : node->operands)
+				{
+					visit(operand);
+				}
+
+				schedule.push_back(node);
+			};
+
+			visit(this->root);
+
+			return schedule;
+		}
+
+		static std::string literal(const double value, const bool doublePrecision)
+		{
+			if (!std::isfinite(value))
+			{
+				return std::isnan(value) ? "(0.0 / 0.0)" : (value > 0.0 ? "(1.0 / 0.0)" : "(-1.0 / 0.0)");
+			}
+
+			std::stringstream stream;
+
+			stream << std::setprecision(17) << std::showpoint << value;
+
+			auto string = stream.str();
+
+			if (string.find_first_of("eE") == std::string::npos && string.find('.') == std::string::npos)
+			{
+				string += ".0";
+			}
+
+			return "(" + string + (doublePrecision ? "lf" : "") + ")";
+		}
+
+	public:
+		static std::shared_ptr<Expression> parse(const std::string& source, const std::vector<Variable>& variables, std::string& error)
+		{
+			auto expression = std::make_shared<Expression>();
+
+			expression->variables = variables;
+
+			try
+			{
+				expression->root = Parser(source, variables, expression->builder).parse();
+			}
+			catch (const std::exception& exception)
+			{
+				error = exception.what();
+
+				return nullptr;
+			}
+
+			error = "";
+
+			return expression;
+		}
+
+		bool isReal() const
+		{
+			return this->root->real;
+		}
+
+		static std::string getGLSLFunctions(const bool doublePrecision)
+		{
+			std::string code = doublePrecision ? "\n#define FS double\n#define FV dvec2\n" : "\n#define FS float\n#define FV vec2\n";
+
+			code += CODE(
+				FV formulaMultiply(const FV a, const FV b) { return FV(a.x * b.x - a.y * b.y, a.x * b.y + a.y * b.x); }
+				FV formulaDivide(const FV a, const FV b) { return FV(a.x * b.x + a.y * b.y, a.y * b.x - a.x * b.y) / dot(b, b); }
+				FV formulaSquare(const FV a) { return FV(a.x * a.x - a.y * a.y, 2.0 * a.x * a.y); }
+				FV formulaExp(const FV a) { return FS(exp(float(a.x))) * FV(cos(float(a.y)), sin(float(a.y))); }
+				FV formulaLog(const FV a) { return FV(log(float(length(a))), atan(float(a.y), float(a.x))); }
+				FV formulaSin(const FV a) { return FV(sin(float(a.x)) * cosh(float(a.y)), cos(float(a.x)) * sinh(float(a.y))); }
+				FV formulaCos(const FV a) { return FV(cos(float(a.x)) * cosh(float(a.y)), -sin(float(a.x)) * sinh(float(a.y))); }
+				FV formulaTan(const FV a) { return formulaDivide(formulaSin(a), formulaCos(a)); }
+				FV formulaSqrt(const FV a) { FS r = length(a); return FV(sqrt((r + a.x) / 2.0), (a.y < 0.0 ? -1.0 : 1.0) * sqrt(max(FS(0.0), (r - a.x) / 2.0))); }
+				FV formulaPower(const FV a, const FV b) { return a == FV(0.0) ? FV(0.0) : formulaExp(formulaMultiply(b, formulaLog(a))); }
+				FS formulaPowerReal(const FS a, const FS b) { FS p = FS(pow(abs(float(a)), float(b))); return a < 0.0 && mod(b, 2.0) == 1.0 ? -p : p; }
+			);
+
+			code += "\n#undef FS\n#undef FV\n";
+
+			return code;
+		}
+
+		std::string compileGLSL(const std::string& name, const bool doublePrecision, const bool complexResult) const
+		{
+			std::string s = doublePrecision ? "double" : "float";
+			std::string v = doublePrecision ? "dvec2" : "vec2";
+
+			auto schedule = this->getSchedule();
+
+			std::map<std::size_t, std::string> names;
+
+			auto complex = [&](const NodePtr& node) { return node->real ? v + "(" + names[node->id] + ", 0.0)" : names[node->id]; };
+			auto real = [&](const NodePtr& node) { return node->real ? names[node->id] : names[node->id] + ".x"; };
+			auto transcendental = [&](const std::string& function, const std::string& argument) { return doublePrecision ? s + "(" + function + "(float(" + argument + ")))" : function + "(" + argument + ")"; };
+
+			std::string code = (complexResult ? v : s) + " " + name + "(";
+
+			for (std::size_t i = 0; i < this->variables.size(); i++)
+			{
+				code += (i > 0 ? ", " : "") + std::string("const ") + (this->variables[i].real ? s : v) + " " + this->variables[i].name;
+			}
+
+			code += ")\n{\n";
+
+			for (const auto& node : schedule)
+			{
+				if (node->operation == Operation::Variable)
+				{
+					names[node->id] = this->variables[node->variable].name;
+
+					continue;
+				}
+
+				if (node->operation == Operation::Constant)
+				{
+					names[node->id] = node->real ? s + literal(node->value.x, doublePrecision) : v + "(" + literal(node->value.x, doublePrecision) + ", " + literal(node->value.y, doublePrecision) + ")";
+
+					continue;
+				}
+
+				const auto& a = node->operands[0];
+				const auto& b = node->operands.size() > 1 ? node->operands[1] : node->operands[0];
+
+				std::string expression;
+
+				switch (node->operation)
+				{
+				case Operation::Add:
+					expression = node->real ? names[a->id] + " + " + names[b->id] : complex(a) + " + " + complex(b);
+					break;
+				case Operation::Subtract:
+					expression = node->real ? names[a->id] + " - " + names[b->id] : complex(a) + " - " + complex(b);
+					break;
+				case Operation::Multiply:
+					expression = a->real || b->real ? names[a->id] + " * " + names[b->id] : "formulaMultiply(" + names[a->id] + ", " + names[b->id] + ")";
+					break;
+				case Operation::Divide:
+					expression = b->real ? names[a->id] + " / " + names[b->id] : "formulaDivide(" + complex(a) + ", " + names[b->id] + ")";
+					break;
+				case Operation::Negate:
+					expression = "-" + names[a->id];
+					break;
+				case Operation::Square:
+					expression = node->real ? names[a->id] + " * " + names[a->id] : "formulaSquare(" + names[a->id] + ")";
+					break;
+				case Operation::Power:
+					expression = node->real ? "formulaPowerReal(" + names[a->id] + ", " + names[b->id] + ")" : "formulaPower(" + complex(a) + ", " + complex(b) + ")";
+					break;
+				case Operation::Sin:
+					expression = node->real ? transcendental("sin", names[a->id]) : "formulaSin(" + names[a->id] + ")";
+					break;
+				case Operation::Cos:
+					expression = node->real ? transcendental("cos", names[a->id]) : "formulaCos(" + names[a->id] + ")";
+					break;
+				case Operation::Tan:
+					expression = node->real ? transcendental("tan", names[a->id]) : "formulaTan(" + names[a->id] + ")";
+					break;
+				case Operation::Exp:
+					expression = node->real ? transcendental("exp", names[a->id]) : "formulaExp(" + names[a->id] + ")";
+					break;
+				case Operation::Log:
+					expression = node->real ? transcendental("log", names[a->id]) : "formulaLog(" + complex(a) + ")";
+					break;
+				case Operation::Sqrt:
+					expression = node->real ? "sqrt(" + names[a->id] + ")" : "formulaSqrt(" + complex(a) + ")";
+					break;
+				case Operation::Abs:
+					expression = a->real ? "abs(" + names[a->id] + ")" : "length(" + names[a->id] + ")";
+					break;
+				case Operation::Re:
+					expression = real(a);
+					break;
+				case Operation::Im:
+					expression = names[a->id] + ".y";
+					break;
+				case Operation::Conj:
+					expression = v + "(" + names[a->id] + ".x, -" + names[a->id] + ".y)";
+					break;
+				case Operation::Norm:
+					expression = a->real ? names[a->id] + " * " + names[a->id] : "dot(" + names[a->id] + ", " + names[a->id] + ")";
+					break;
+				case Operation::Arg:
+					expression = a->real ? "(" + names[a->id] + " < 0.0 ? " + s + literal(3.14159265358979323846, doublePrecision) + " : " + s + "(0.0))" : s + "(atan(float(" + names[a->id] + ".y), float(" + names[a->id] + ".x)))";
+					break;
+				case Operation::Floor:
+					expression = "floor(" + real(a) + ")";
+					break;
+				case Operation::Min:
+					expression = "min(" + real(a) + ", " + real(b) + ")";
+					break;
+				case Operation::Max:
+					expression = "max(" + real(a) + ", " + real(b) + ")";
+					break;
+				case Operation::Less:
+					expression = s + "(" + real(a) + " < " + real(b) + ")";
+					break;
+				case Operation::LessEqual:
+					expression = s + "(" + real(a) + " <= " + real(b) + ")";
+					break;
+				case Operation::Greater:
+					expression = s + "(" + real(a) + " > " + real(b) + ")";
+					break;
+				case Operation::GreaterEqual:
+					expression = s + "(" + real(a) + " >= " + real(b) + ")";
+					break;
+				case Operation::Equal:
+					expression = s + "(" + real(a) + " == " + real(b) + ")";
+					break;
+				case Operation::NotEqual:
+					expression = s + "(" + real(a) + " != " + real(b) + ")";
+					break;
+				case Operation::And:
+					expression = s + "(" + real(a) + " != 0.0 && " + real(b) + " != 0.0)";
+					break;
+				case Operation::Or:
+					expression = s + "(" + real(a) + " != 0.0 || " + real(b) + " != 0.0)";
+					break;
+				case Operation::Not:
+					expression = s + "(" + real(a) + " == 0.0)";
+					break;
+				case Operation::Select:
+					expression = real(a) + " != 0.0 ? " + (node->real ? names[node->operands[1]->id] : complex(node->operands[1])) + " : " + (node->real ? names[node->operands[2]->id] : complex(node->operands[2]));
+					break;
+				default:
+					break;
+				}
+
+				names[node->id] = "t" + std::to_string(node->id);
+
+				code += "\t" + (node->real ? s : v) + " " + names[node->id] + " = " + expression + ";\n";
+			}
+
+			code += "\treturn " + (complexResult ? complex(this->root) : real(this->root)) + ";\n}\n";
+
+			return code;
+		}
+
+		Program compileProgram() const
+		{
+			auto schedule = this->getSchedule();
+
+			std::int32_t numVariables = static_cast<std::int32_t>(this->variables.size());
+
+			std::map<std::size_t, std::int32_t> registers;
+			std::map<std::size_t, std::size_t> lastUse;
+
+			std::vector<std::pair<std::int32_t, glm::dvec2>> constants;
+
+			std::int32_t numRegisters = numVariables;
+
+			for (std::size_t i = 0; i < schedule.size(); i++)
+			{
+				const auto& node = schedule[i];
+
+				if (node->operation == Operation::Variable)
+				{
+					registers[node->id] = node->variable;
+				}
+				else if (node->operation == Operation::Constant)
+				{
+					registers[node->id] = numRegisters++;
+
+					constants.push_back(std::make_pair(registers[node->id], node->value));
+				}
+
+				for (const auto& operand : node->operands)
+				{
+					lastUse[operand->id] = i;
+				}
+			}
+
+			lastUse[this->root->id] = schedule.size();
+
+			std::vector<std::int32_t> freeRegisters;
+			std::vector<Instruction> instructions;
+
+			for (std::size_t i = 0; i < schedule.size(); i++)
+			{
+				const auto& node = schedule[i];
+
+				if (node->operation == Operation::Variable || node->operation == Operation::Constant)
+				{
+					continue;
+				}
+
+				const auto& a = node->operands[0];
+				const auto& b = node->operands.size() > 1 ? node->operands[1] : node->operands[0];
+				const auto& c = node->operands.size() > 2 ? node->operands[2] : node->operands[0];
+
+				Instruction instruction = { Opcode::Add, 0, registers[a->id], registers[b->id], registers[c->id] };
+
+				bool realOperands = a->real && b->real;
+
+				switch (node->operation)
+				{
+				case Operation::Add: instruction.opcode = realOperands ? Opcode::AddReal : Opcode::Add; break;
+				case Operation::Subtract: instruction.opcode = realOperands ? Opcode::SubtractReal : Opcode::Subtract; break;
+				case Operation::Multiply:
+				{
+					if (realOperands)
+					{
+						instruction.opcode = Opcode::MultiplyReal;
+					}
+					else if (a->real || b->real)
+					{
+						instruction.opcode = Opcode::MultiplyRealComplex;
+
+						if (!a->real)
+						{
+							std::swap(instruction.a, instruction.b);
+						}
+					}
+					else
+					{
+						instruction.opcode = Opcode::Multiply;
+					}
+
+					break;
+				}
+				case Operation::Divide: instruction.opcode = realOperands ? Opcode::DivideReal : (b->real ? Opcode::DivideComplexReal : Opcode::Divide); break;
+				case Operation::Negate: instruction.opcode = node->real ? Opcode::NegateReal : Opcode::Negate; break;
+				case Operation::Square: instruction.opcode = node->real ? Opcode::SquareReal : Opcode::Square; break;
+				case Operation::Power: instruction.opcode = node->real ? Opcode::PowerReal : Opcode::Power; break;
+				case Operation::Sin: instruction.opcode = node->real ? Opcode::SinReal : Opcode::Sin; break;
+				case Operation::Cos: instruction.opcode = node->real ? Opcode::CosReal : Opcode::Cos; break;
+				case Operation::Tan: instruction.opcode = node->real ? Opcode::TanReal : Opcode::Tan; break;
+				case Operation::Exp: instruction.opcode = node->real ? Opcode::ExpReal : Opcode::Exp; break;
+				case Operation::Log: instruction.opcode = node->real ? Opcode::LogReal : Opcode::Log; break;
+				case Operation::Sqrt: instruction.opcode = node->real ? Opcode::SqrtReal : Opcode::Sqrt; break;
+				case Operation::Abs: instruction.opcode = a->real ? Opcode::AbsReal : Opcode::Abs; break;
+				case Operation::Re: instruction.opcode = Opcode::Re; break;
+				case Operation::Im: instruction.opcode = Opcode::Im; break;
+				case Operation::Conj: instruction.opcode = Opcode::Conj; break;
+				case Operation::Norm: instruction.opcode = Opcode::Norm; break;
+				case Operation::Arg: instruction.opcode = Opcode::Arg; break;
+				case Operation::Floor: instruction.opcode = Opcode::Floor; break;
+				case Operation::Min: instruction.opcode = Opcode::Min; break;
+				case Operation::Max: instruction.opcode = Opcode::Max; break;
+				case Operation::Less: instruction.opcode = Opcode::Less; break;
+				case Operation::LessEqual: instruction.opcode = Opcode::LessEqual; break;
+				case Operation::Greater: instruction.opcode = Opcode::Greater; break;
+				case Operation::GreaterEqual: instruction.opcode = Opcode::GreaterEqual; break;
+				case Operation::Equal: instruction.opcode = Opcode::Equal; break;
+				case Operation::NotEqual: instruction.opcode = Opcode::NotEqual; break;
+				case Operation::And: instruction.opcode = Opcode::And; break;
+				case Operation::Or: instruction.opcode = Opcode::Or; break;
+				case Operation::Not: instruction.opcode = Opcode::Not; break;
+				case Operation::Select: instruction.opcode = Opcode::Select; break;
+				default: break;
+				}
+
+				for (const auto& operand : node->operands)
+				{
+					bool temporary = operand->operation != Operation::Variable && operand->operation != Operation::Constant;
+
+					if (temporary && lastUse[operand->id] == i && registers[operand->id] >= 0)
+					{
+						freeRegisters.push_back(registers[operand->id]);
+
+						registers[operand->id] = -1;
+					}
+				}
+
+				if (freeRegisters.empty())
+				{
+					instruction.target = numRegisters++;
+				}
+				else
+				{
+					instruction.target = freeRegisters.back();
+
+					freeRegisters.pop_back();
+				}
+
+				registers[node->id] = instruction.target;
+
+				instructions.push_back(instruction);
+			}
+
+			return Program(numVariables, numRegisters, registers[this->root->id], constants, instructions);
+		}
+	};
+}
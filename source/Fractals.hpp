@@ -2,6 +2,12 @@
 
 #include "OpenGLHelper.hpp"
 #include "Image.hpp"
+#include "Formula.hpp"
+#include "Nucleus.hpp"
+#include "IFS.hpp"
+#include "Random.hpp"
+#include "Collage.hpp"
+#include "Screening.hpp"
 
 namespace fractals
 {
@@ -49,11 +55,26 @@ namespace fractals
 			return 1;
 		}
 
+		virtual bool navigate(Viewport& viewport)
+		{
+			return false;
+		}
+
+		virtual bool converged() const
+		{
+			return false;
+		}
+
 		virtual void options()
 		{
 
 		}
 
+		virtual void info()
+		{
+
+		}
+
 		virtual void dropImage(const img::ImagePtr& image)
 		{
 
@@ -78,11 +99,22 @@ namespace fractals
 		glm::mat2x2 matrix;
 		glm::vec2 offset;
 		float p = 0.0f;
+		ifs::Variations variations;
 	};
 
 	class Affine : public Fractal
 	{
 	public:
+		static constexpr float densityColorScale = 256.0f;
+		static constexpr std::uint32_t densitySaturation = 0xF0000000u;
+
+		enum class Engine : int
+		{
+			GPU = 0,
+			ChaosGame = 1,
+			SetIteration = 2,
+		};
+
 		struct InitialSet
 		{
 			enum class Type : int
@@ -186,14 +218,190 @@ namespace fractals
 			return Fractal(viewport, affineTransforms);
 		}
 
+		inline static std::vector<ifs::Map> toMaps(const std::vector<AffineTransform>& affineTransforms)
+		{
+			std::vector<ifs::Map> maps;
+
+			for (const auto& affineTransform : affineTransforms)
+			{
+				maps.push_back(ifs::Map(affineTransform.matrix, affineTransform.offset, affineTransform.p));
+			}
+
+			return maps;
+		}
+
+		inline static std::vector<ifs::Variations> toVariations(const std::vector<AffineTransform>& affineTransforms)
+		{
+			std::vector<ifs::Variations> variations;
+
+			for (const auto& affineTransform : affineTransforms)
+			{
+				variations.push_back(affineTransform.variations);
+			}
+
+			return variations;
+		}
+
+		inline static std::vector<AffineTransform> fromMaps(const std::vector<ifs::Map>& maps)
+		{
+			std::vector<AffineTransform> affineTransforms;
+
+			for (const auto& map : maps)
+			{
+				affineTransforms.push_back({ glm::mat2x2(glm::vec2(map.a, map.c), glm::vec2(map.b, map.d)), glm::vec2(map.e, map.f), map.p });
+			}
+
+			return affineTransforms;
+		}
+
 	private:
 		std::vector<AffineTransform> affineTransforms;
 
+		std::uint32_t seed;
+
+		Engine engine;
+		std::shared_ptr<ifs::ChaosGame> chaosGame;
+		std::shared_ptr<ifs::Hutchinson> hutchinson;
+		std::int32_t pointsPerIteration;
+		double pointsPerSecond;
+
+		bool deterministic;
+		float contraction;
+
+		ifs::Iteration iteration;
+		bool gatherable;
+
+		bool frontierValid;
+		std::uint64_t frontierSize;
+		RAIIWrapper<GLuint> bufferFrontier;
+		RAIIWrapper<GLuint> bufferFrontierBuffered;
+		RAIIWrapper<GLuint> bufferFrontierCounts;
+		RAIIWrapper<GLuint> bufferFrontierCountsBuffered;
+		RAIIWrapper<GLuint> programFrontier;
+		GLint locationFrontierCounter;
+		GLint locationFrontierPrevious;
+		GLint locationFrontierNumMaps;
+		RAIIWrapper<GLuint> programCompact;
+		GLint locationCompactCounter;
+
+		bool fuse;
+		std::int32_t fusedDepth;
+		std::uint64_t activeSize;
+		GLint numFusedMaps;
+		RAIIWrapper<GLuint> bufferMapsFused;
+		RAIIWrapper<GLuint> textureMapsFused;
+
+		std::uint32_t variationMask;
+		RAIIWrapper<GLuint> bufferWeights;
+		RAIIWrapper<GLuint> textureWeights;
+
+		RAIIWrapper<GLuint> bufferCounts;
+		GLint locationIterateCountChanges;
+		GLint locationGatherCountChanges;
+
+		bool density;
+		bool densityColored;
+		float gamma;
+		float brightness;
+		std::uint64_t densityMaximum;
+		RAIIWrapper<GLuint> textureDensity;
+		RAIIWrapper<GLuint> textureDensityColors;
+		RAIIWrapper<GLuint> textureDensityColorsHigh;
+		RAIIWrapper<GLuint> textureDensityMaximum;
+		RAIIWrapper<GLuint> framebufferDensity;
+
+		bool splat;
+		std::int32_t splatPoints;
+		std::int32_t splatCapacity;
+		std::uint64_t splatCount;
+		RAIIWrapper<GLuint> bufferSplat;
+		RAIIWrapper<GLuint> bufferSplatBuffered;
+		RAIIWrapper<GLuint> textureSplat;
+		RAIIWrapper<GLuint> textureSplatBuffered;
+		RAIIWrapper<GLuint> programSplat;
+		GLint locationSplatCounter;
+		GLint locationSplatSeed;
+		GLint locationSplatNumMaps;
+		GLint locationSplatColorScale;
+		GLint locationSplatSaturation;
+		RAIIWrapper<GLuint> programResolve;
+		GLint locationResolveLogMaximum;
+		GLint locationResolveColorScale;
+		GLint locationResolveGamma;
+		GLint locationResolveBrightness;
+		GLint locationResolveColored;
+		GLint locationResolvePrimary;
+		GLint locationResolveSecondary;
+		GLint locationResolveBackground;
+
+		bool sparse;
+		bool sparseActive;
+		glm::ivec2 pageSizeSet;
+		glm::ivec2 pageSizeColor;
+		std::vector<std::uint8_t> pagesSet;
+		std::vector<std::uint8_t> pagesSetBuffered;
+		std::vector<std::uint8_t> pagesColor;
+
+		bool codeTreeRender;
+		bool codeTreeValid;
+		std::shared_ptr<ifs::CodeTree> codeTree;
+		RAIIWrapper<GLuint> textureCodeTree;
+		glm::ivec2 codeTreeResolution;
+		Viewport codeTreeViewport;
+		glm::vec3 codeTreeColorPrimary;
+		glm::vec3 codeTreeColorBackground;
+
+		bool dimension;
+		bool dimensionValid;
+		bool bitsValid;
+		std::shared_ptr<ifs::BoxCounter> boxCounter;
+		RAIIWrapper<GLuint> textureBits;
+		RAIIWrapper<GLuint> textureBitsPrevious;
+		RAIIWrapper<GLuint> textureDirtyTiles;
+		RAIIWrapper<GLuint> framebufferBits;
+		RAIIWrapper<GLuint> programPack;
+		GLint locationPackCounter;
+		GLint locationPackDensity;
+		GLint locationPackSize;
+		GLint locationPackTileSize;
+
+		bool autoStop;
+		bool warmStart;
+		bool fitViewport;
+		std::uint64_t numChanged;
+		bool countsValid;
+		bool isConverged;
+
 		InitialSet initialSet;
+		std::string distributionError;
+		std::shared_ptr<formula::Expression> distributionExpression;
 		RAIIWrapper<GLuint> textureInitialSet;
+		RAIIWrapper<GLuint> bufferInitialPoints;
+		RAIIWrapper<GLuint> textureInitialPoints;
+		RAIIWrapper<GLuint> programInitPoints;
+
+		bool encodeDropped;
+		collage::Settings collageSettings;
+		collage::Result collageResult;
+		double collageSeconds;
+		std::chrono::steady_clock::time_point collageBegin;
+		std::future<collage::Result> collageTask;
+		img::ImagePtr collageImage;
+
+		screening::Settings screeningSettings;
+		std::vector<screening::Result> screeningResults;
+		double screeningSeconds;
+		std::int32_t numScreened;
+		std::uint64_t numScreeningRejected;
 
 		std::vector<std::uint32_t> pixels;
 		RAIIWrapper<GLuint> textureSet;
+		RAIIWrapper<GLuint> textureSetBuffered;
+		RAIIWrapper<GLuint> textureSetPacked;
+
+		RAIIWrapper<GLuint> bufferMaps;
+		RAIIWrapper<GLuint> textureMaps;
+		RAIIWrapper<GLuint> bufferParameters;
 
 		std::string vertexShaderCode;
 
@@ -203,7 +411,14 @@ namespace fractals
 		GLint locationInitSeed;
 		RAIIWrapper<GLuint> programIterate;
 		GLint locationIterateCounter;
-		GLint locationIterateSeed;
+		GLint locationIteratePrevious;
+		GLint locationIterateNumMaps;
+		RAIIWrapper<GLuint> framebufferGather;
+		RAIIWrapper<GLuint> programGather;
+		GLint locationGatherCounter;
+		GLint locationGatherNumMaps;
+		RAIIWrapper<GLuint> programReseed;
+		GLint locationReseedCounter;
 		RAIIWrapper<GLuint> programColor;
 		GLint locationColorCounter;
 		glm::vec3 colorPrimary;
@@ -214,6 +429,7 @@ namespace fractals
 		GLint locationColorBackground;
 		bool falloff;
 		GLint locationFalloff;
+		GLint locationColorPacked;
 
 		RAIIWrapper<GLuint> textureColor;
 		RAIIWrapper<GLuint> programRender;
@@ -223,39 +439,18 @@ namespace fractals
 		Viewport viewport;
 		GLint locationViewport;
 		GLint locationViewportRequested;
+		GLint locationRenderBackground;
 
 		static inline std::int32_t findBestIndex(const std::int32_t lower, const std::int32_t upper, const std::int32_t size, const float begin, const float end, float value)
 		{
-			if (lower >= upper - 1)
-			{
-				float fLower = begin + (float(lower) + 0.5f) / float(size) * (end - begin);
-				float fUpper = begin + (float(upper) + 0.5f) / float(size) * (end - begin);
-
-				float distance1 = glm::abs(fLower - value);
-				float distance2 = glm::abs(fUpper - value);
-
-				if (distance1 <= distance2)
-				{
-					return lower;
-				}
-				else
-				{
-					return upper;
-				}
-			}
-
-			std::int32_t middle = (upper + lower) / 2;
+			float index = glm::floor((value - begin) / (end - begin) * float(size));
 
-			float fMiddle = begin + (float(middle) + 0.5f) / float(size) * (end - begin);
-
-			if (value <= fMiddle)
-			{
-				return findBestIndex(lower, middle, size, begin, end, value);
-			}
-			else
+			if (!(index > float(lower)))
 			{
-				return findBestIndex(middle, upper, size, begin, end, value);
+				return lower;
 			}
+
+			return static_cast<std::int32_t>(glm::min(double(index), double(upper)));
 		}
 
 		static inline glm::ivec2 findBestPixel(const glm::ivec2& lower, const glm::ivec2& upper, const glm::ivec2& size, const Viewport& viewport, const glm::vec2& point)
@@ -269,6 +464,8 @@ namespace fractals
 	public:
 		Affine(const glm::ivec2& size, const Fractal& fractal, const InitialSet& initialSet = InitialSet()) :
 			initialSet(initialSet), viewport(fractal.viewport), affineTransforms(fractal.affineTransforms),
+			seed(0), engine(Engine::GPU), pointsPerIteration(1 << 22), pointsPerSecond(0.0),
+			iteration(ifs::Iteration::Frontier), gatherable(false), frontierValid(false), frontierSize(0), fuse(true), fusedDepth(0), activeSize(0), numFusedMaps(0), variationMask(0), density(false), densityColored(true), gamma(2.2f), brightness(1.0f), densityMaximum(0), splat(false), splatPoints(1 << 20), splatCapacity(0), splatCount(0), sparse(false), sparseActive(false), pageSizeSet(1), pageSizeColor(1), codeTreeRender(false), codeTreeValid(false), dimension(false), dimensionValid(false), bitsValid(false), autoStop(true), warmStart(true), fitViewport(false), numChanged(0), countsValid(false), isConverged(false), encodeDropped(false), collageSeconds(0.0), screeningSeconds(0.0), numScreened(0), numScreeningRejected(0),
 			colorPrimary(glm::vec3(0.0, 1.0, 0.0)), colorSecondary(glm::vec3(1.0, 0.0, 0.0)), colorBackground(glm::vec3(0.0, 0.0, 0.0)),
 			falloff(true), counter(1), size(size)
 		{
@@ -285,6 +482,15 @@ namespace fractals
 			);
 
 			gl::requireExtension("GL_ARB_shader_image_load_store");
+			gl::requireExtension("GL_ARB_shader_atomic_counters");
+
+			this->bufferCounts = RAIIWrapper<GLuint>(glCreate(Buffer)(), glDelete(Buffer));
+
+			glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, this->bufferCounts);
+
+			glBufferData(GL_ATOMIC_COUNTER_BUFFER, 3 * sizeof(GLuint), nullptr, GL_DYNAMIC_READ);
+
+			glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
 
 			auto fragmentShaderCode = CODE(\
 				#version 420 core \n\
@@ -301,12 +507,24 @@ namespace fractals
 				uniform vec3 colorBackground;
 
 				uniform bool falloff;
+				uniform bool bitPacked;
 
 				out vec4 color;
 
 				void main()
 				{
-					uint value = imageLoad(image, ivec2(gl_FragCoord.xy)).r & 0x7FFFFFFFu;
+					ivec2 index = ivec2(gl_FragCoord.xy);
+
+					uint value = 0u;
+
+					if (bitPacked)
+					{
+						value = ((imageLoad(image, ivec2(index.x >> 5, index.y)).r >> uint(index.x & 31)) & 1u) != 0u ? counter : 0u;
+					}
+					else
+					{
+						value = imageLoad(image, index).r & 0x7FFFFFFFu;
+					}
 
 					if (value == counter)
 					{
@@ -332,6 +550,106 @@ namespace fractals
 			this->locationColorBackground = glGetUniformLocation(this->programColor, "colorBackground");
 
 			this->locationFalloff = glGetUniformLocation(this->programColor, "falloff");
+			this->locationColorPacked = glGetUniformLocation(this->programColor, "bitPacked");
+
+
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
+
+				precision highp float;
+
+				layout(binding = 0) uniform usampler2D samplerHits;
+				layout(binding = 1) uniform usampler2D samplerColors;
+				layout(binding = 2) uniform usampler2D samplerColorsHigh;
+
+				uniform float logMaximum;
+				uniform float colorScale;
+				uniform float gamma;
+				uniform float brightness;
+
+				uniform bool colored;
+
+				uniform vec3 colorPrimary;
+				uniform vec3 colorSecondary;
+				uniform vec3 colorBackground;
+
+				out vec4 color;
+
+				void main()
+				{
+					float hits = float(texelFetch(samplerHits, ivec2(gl_FragCoord.xy), 0).r);
+					float colorLow = float(texelFetch(samplerColors, ivec2(gl_FragCoord.xy), 0).r);
+					float colorHigh = float(texelFetch(samplerColorsHigh, ivec2(gl_FragCoord.xy), 0).r);
+
+					float colorSum = (colorHigh * 4294967296.0 + colorLow) / colorScale;
+
+					float alpha = pow(clamp(brightness * log(1.0 + hits) / logMaximum, 0.0, 1.0), 1.0 / gamma);
+
+					vec3 tint = colored && hits > 0.0 ? mix(colorSecondary, colorPrimary, clamp(colorSum / hits, 0.0, 1.0)) : colorPrimary;
+
+					color = vec4(mix(colorBackground, tint, alpha), 1.0);
+				}
+			);
+
+			this->programResolve = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationResolveLogMaximum = glGetUniformLocation(this->programResolve, "logMaximum");
+			this->locationResolveColorScale = glGetUniformLocation(this->programResolve, "colorScale");
+			this->locationResolveGamma = glGetUniformLocation(this->programResolve, "gamma");
+			this->locationResolveBrightness = glGetUniformLocation(this->programResolve, "brightness");
+			this->locationResolveColored = glGetUniformLocation(this->programResolve, "colored");
+
+			this->locationResolvePrimary = glGetUniformLocation(this->programResolve, "colorPrimary");
+			this->locationResolveSecondary = glGetUniformLocation(this->programResolve, "colorSecondary");
+			this->locationResolveBackground = glGetUniformLocation(this->programResolve, "colorBackground");
+
+
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_shader_image_load_store : enable \n\
+
+				layout(binding = 0) uniform usampler2D samplerSet;
+				layout(binding = 1) uniform usampler2D samplerPrevious;
+
+				layout(r32ui, binding = 0) uniform writeonly uimage2D imageDirty;
+
+				uniform uint counter;
+				uniform bool density;
+				uniform ivec2 size;
+				uniform ivec2 tileSize;
+
+				layout(location = 0) out uint bits;
+
+				void main()
+				{
+					ivec2 index = ivec2(gl_FragCoord.xy);
+
+					uint result = 0u;
+
+					for (int i = 0; i < 32 && index.x * 32 + i < size.x; i++)
+					{
+						uint value = texelFetch(samplerSet, ivec2(index.x * 32 + i, index.y), 0).r;
+
+						bool inSet = density ? value > 0u : (value & 0x7FFFFFFFu) == counter;
+
+						result |= uint(inSet) << uint(i);
+					}
+
+					if (result != texelFetch(samplerPrevious, index, 0).r)
+					{
+						imageStore(imageDirty, index / tileSize, uvec4(1u, 0u, 0u, 0u));
+					}
+
+					bits = result;
+				}
+			);
+
+			this->programPack = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationPackCounter = glGetUniformLocation(this->programPack, "counter");
+			this->locationPackDensity = glGetUniformLocation(this->programPack, "density");
+			this->locationPackSize = glGetUniformLocation(this->programPack, "size");
+			this->locationPackTileSize = glGetUniformLocation(this->programPack, "tileSize");
 
 			
 			fragmentShaderCode = CODE(\
@@ -347,6 +665,8 @@ namespace fractals
 				uniform vec4 viewport;
 				uniform vec4 viewportRequested;
 
+				uniform vec3 colorBackground;
+
 				out vec4 color;
 
 				vec2 fromScreen(const vec2 screen, const vec4 viewport)
@@ -365,7 +685,9 @@ namespace fractals
 
 					vec2 pos = toScreen(fromScreen(screen, viewportRequested), viewport);
 
-					color = texture(sampler, pos);
+					vec4 texel = texture(sampler, pos);
+
+					color = vec4(texel.rgb + (1.0 - texel.a) * colorBackground, 1.0);
 				}
 			);
 
@@ -377,1011 +699,4657 @@ namespace fractals
 			this->locationViewport = glGetUniformLocation(this->programRender, "viewport");
 			this->locationViewportRequested = glGetUniformLocation(this->programRender, "viewportRequested");
 
+			this->locationRenderBackground = glGetUniformLocation(this->programRender, "colorBackground");
+
+
+			this->bufferParameters = RAIIWrapper<GLuint>(glCreate(Buffer)(), glDelete(Buffer));
+
+			this->compileIterationPrograms();
+
+			this->compileInitialSetProgram();
 
 			this->setup();
 		}
 
 	private:
-		void setup()
+		std::string getParametersCode() const
 		{
-			this->textureSet = nullptr;
-			this->framebufferIterate = nullptr;
-			this->textureColor = nullptr;
+			return CODE(
+				layout(std140, binding = 0) uniform Parameters
+				{
+					vec4 viewport;
+					ivec2 size;
+				};
 
+				vec2 fromScreen(const vec2 screen)
+				{
+					return viewport.xz + screen * (viewport.yw - viewport.xz);
+				}
 
-			this->textureSet = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+				vec2 toScreen(const vec2 pos)
+				{
+					return (pos - viewport.xz) / (viewport.yw - viewport.xz);
+				}
+			);
+		}
 
-			glBindTexture(GL_TEXTURE_2D, this->textureSet);
+		void compileIterationPrograms()
+		{
+			auto fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_shader_image_load_store : enable \n\
+				#extension GL_ARB_shader_atomic_counters : enable \n\
 
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, size.x, size.y, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+				precision highp float;
+				
+				layout(r32ui, binding = 0) uniform uimage2D image;
 
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+				layout(binding = 0) uniform samplerBuffer maps;
 
+				layout(binding = 0, offset = 0) uniform atomic_uint sources;
+				layout(binding = 0, offset = 4) uniform atomic_uint written;
+				layout(binding = 0, offset = 8) uniform atomic_uint kept;
 
-			this->framebufferIterate = RAIIWrapper<GLuint>(glCreate(Framebuffer)(), glDelete(Framebuffer));
+				uniform bool countChanges;
+				uniform int numMaps;
 
-			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+				uniform uint counter;
+				uniform uint previous;
 
-			this->textureColor = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+				out vec4 color;
+			);
 
-			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+			fragmentShaderCode += this->getParametersCode();
 
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			fragmentShaderCode += ifs::getVariationGLSLFunction(this->variationMask);
 
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+			fragmentShaderCode += CODE(
+				void plot(const vec2 pos, const int k)
+				{
+					vec4 linear = texelFetch(maps, 3 * k);
+					vec2 offset = texelFetch(maps, 3 * k + 1).xy;
 
-			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->textureColor, 0);
+					ivec2 index = ivec2(toScreen(vary(mat2x2(linear.xy, linear.zw) * pos + offset, k)) * size);
 
-			GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
+					uint value = imageLoad(image, index).r;
 
-			glDrawBuffers(1, drawBuffers);
+					uint newValue = counter;
 
-			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-			{
-				throw std::runtime_error("GL-Error: Framebuffer not completed.");
-			}
+					if ((value & 0x7FFFFFFFu) == previous)
+					{
+						newValue |= 0x80000000u;
+					}
+					else if ((value & 0x7FFFFFFFu) == counter)
+					{
+						newValue = value;
+					}
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+					uint oldValue = imageAtomicExchange(image, index, newValue);
+
+					if (countChanges && all(greaterThanEqual(index, ivec2(0))) && all(lessThan(index, size)) && (oldValue & 0x7FFFFFFFu) != counter)
+					{
+						atomicCounterIncrement(written);
 
+						if ((oldValue & 0x7FFFFFFFu) == previous)
+						{
+							atomicCounterIncrement(kept);
+						}
+					}
+				}
 
-			bool probabilistic = false;
+				void main()
+				{
+					ivec2 index = ivec2(gl_FragCoord.xy);
 
-			std::vector<float> cdf;
+					uint value = imageLoad(image, index).r;
 
-			for (const auto& affineTransform : this->affineTransforms)
-			{
-				probabilistic |= affineTransform.p > 0.0f;
+					bool flag = (value & 0x80000000u) != 0u;
+					value &= 0x7FFFFFFFu;
 
-				cdf.push_back(affineTransform.p + (cdf.size() > 0 ? *cdf.rbegin() : 0.0f));
-			}
+					if (value == previous || (value == counter && flag))
+					{
+						if (countChanges)
+						{
+							atomicCounterIncrement(sources);
+						}
 
-			std::transform(cdf.begin(), cdf.end(), cdf.begin(), [=](float v) { return v / static_cast<float>(*cdf.rbegin()); });
+						vec2 pos = fromScreen(gl_FragCoord.xy / size);
 
+						for (int k = 0; k < numMaps; k++)
+						{
+							plot(pos, k);
+						}
+					}
+				}
+			);
 
-			auto fragmentShaderCode = CODE(\
+			this->programIterate = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationIterateCounter = glGetUniformLocation(this->programIterate, "counter");
+			this->locationIteratePrevious = glGetUniformLocation(this->programIterate, "previous");
+			this->locationIterateCountChanges = glGetUniformLocation(this->programIterate, "countChanges");
+			this->locationIterateNumMaps = glGetUniformLocation(this->programIterate, "numMaps");
+
+
+			auto vertexShaderCode = CODE(\
 				#version 420 core \n\
-				#extension GL_ARB_shader_image_load_store : enable \n\
 
 				precision highp float;
-				
-				layout(r32ui, binding = 0) uniform uimage2D image;
+
+				layout(binding = 0) uniform samplerBuffer maps;
+				layout(binding = 1) uniform samplerBuffer points;
+
+				uniform int numMaps;
 
 				uniform uint counter;
-				uniform float seed;
+				uniform uint seed;
 
-				out vec4 color;
+				out vec4 point;
 			);
 
-			fragmentShaderCode += "ivec2 size = ivec2(" + std::to_string(size.x) + ", " + std::to_string(size.y) + ");";
-			fragmentShaderCode += "vec4 viewport = vec4(" + std::to_string(viewport.left) + ", " + std::to_string(viewport.right) + ", " + std::to_string(viewport.bottom) + ", " + std::to_string(viewport.top) + ");";
+			vertexShaderCode += this->getParametersCode();
 
-			fragmentShaderCode += CODE(
-				vec2 fromScreen(const vec2 screen)
-				{
-					return viewport.xz + screen * (viewport.yw - viewport.xz);
-				}
+			vertexShaderCode += rng::getGLSLFunctions();
 
-				vec2 toScreen(const vec2 pos)
-				{
-					return (pos - viewport.xz) / (viewport.yw - viewport.xz);
-				}
+			vertexShaderCode += ifs::getVariationGLSLFunction(this->variationMask);
 
-				float noise(vec2 xy, float seed)
+			vertexShaderCode += CODE(
+				void main()
 				{
-					float golden_ratio = 1.61803398874989484820459;
+					vec4 previous = texelFetch(points, gl_VertexID);
 
-					return fract(tan(distance(xy * golden_ratio, xy) * seed) * xy.x);
-				}
+					vec2 random = random2(uint(gl_VertexID), counter, seed);
 
-				void main()
-				{
-					ivec2 index = ivec2(gl_FragCoord.xy);
-					vec2 screen = gl_FragCoord.xy / size;
+					int column = min(int(random.x * float(numMaps)), numMaps - 1);
 
-					uint value = imageLoad(image, index).r;
+					int k = random.y < texelFetch(maps, 3 * column + 1).z ? column : int(texelFetch(maps, 3 * column + 1).w);
 
-					bool flag = (value & 0x80000000) != 0;
-					value &= 0x7FFFFFFFu;
+					vec4 linear = texelFetch(maps, 3 * k);
+					vec2 offset = texelFetch(maps, 3 * k + 1).xy;
 
-					if (value == counter - 1u || (value == counter && flag))
-					{
-						vec2 pos = fromScreen(screen);
-						vec2 newPos;
-						uint newValue;
+					vec2 pos = vary(mat2x2(linear.xy, linear.zw) * previous.xy + offset, k);
 
-						mat2x2 matrix;
-						vec2 offset;
-			);
+					if (any(isnan(pos)) || any(isinf(pos)))
+					{
+						pos = fromScreen(random2(uint(gl_VertexID), ~counter, seed));
+					}
 
-			if (probabilistic)
-			{
-				fragmentShaderCode += "float random = noise(gl_FragCoord.xy, seed + fract(float(" + std::to_string(std::rand() % this->affineTransforms.size()) + ") / " + std::to_string(this->affineTransforms.size()) + "));";
-				fragmentShaderCode += "if (false) { }";
-			}
+					float mapColor = numMaps > 1 ? float(k) / float(numMaps - 1) : 0.5;
 
-			for (std::size_t i = 0; i < this->affineTransforms.size(); i++)
-			{
-				const auto& affineTransform = this->affineTransforms[i];
-				const auto& f = cdf[i];
+					point = vec4(pos, 0.5 * (previous.z + mapColor), 0.0);
 
-				if (probabilistic)
-				{
-					fragmentShaderCode += "else if (random <= " + std::to_string(f) + ")";
-					fragmentShaderCode += "{";
+					gl_Position = vec4(toScreen(pos) * 2.0 - 1.0, 0.0, 1.0);
+					gl_PointSize = 1.0;
 				}
+			);
 
-				fragmentShaderCode += "matrix[0] = vec2(" + std::to_string(affineTransform.matrix[0].x) + ", " + std::to_string(affineTransform.matrix[0].y) + ");";
-				fragmentShaderCode += "matrix[1] = vec2(" + std::to_string(affineTransform.matrix[1].x) + ", " + std::to_string(affineTransform.matrix[1].y) + ");";
-				fragmentShaderCode += "offset = vec2(" + std::to_string(affineTransform.offset.x) + ", " + std::to_string(affineTransform.offset.y) + ");";
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_shader_image_load_store : enable \n\
 
-				fragmentShaderCode += CODE(
-						newPos = matrix * pos + offset;
+				precision highp float;
 
-						index = ivec2(toScreen(newPos) * size);
+				layout(r32ui, binding = 0) uniform uimage2D hits;
+				layout(r32ui, binding = 1) uniform uimage2D colors;
+				layout(r32ui, binding = 2) uniform uimage2D maximum;
+				layout(r32ui, binding = 3) uniform uimage2D colorsHigh;
 
-						value = imageLoad(image, index).r;
+				uniform float colorScale;
+				uniform uint saturation;
 
-						newValue = counter;
+				in vec4 point;
 
-						if ((value & 0x7FFFFFFFu) == counter - 1u)
-						{
-							newValue |= 0x80000000;
-						}
-						else if ((value & 0x7FFFFFFFu) == counter)
-						{
-							newValue = value;
-						}
+				out vec4 color;
 
-						imageAtomicExchange(image, index, newValue);
-				);
-
-				if (probabilistic)
+				void main()
 				{
-					fragmentShaderCode += "}";
-				}
-			}
+					ivec2 index = ivec2(gl_FragCoord.xy);
 
-			fragmentShaderCode += CODE(
+					color = vec4(0.0);
+
+					uint previous = imageAtomicAdd(hits, index, 1u);
+
+					if (previous >= saturation)
+					{
+						imageAtomicMin(hits, index, saturation);
+						imageAtomicMax(maximum, ivec2(0), saturation);
+
+						return;
+					}
+
+					uint value = uint(point.z * colorScale + 0.5);
+
+					uint sum = imageAtomicAdd(colors, index, value);
+
+					if (sum + value < sum)
+					{
+						imageAtomicAdd(colorsHigh, index, 1u);
 					}
+
+					imageAtomicMax(maximum, ivec2(0), previous + 1u);
 				}
 			);
 
-			this->programIterate = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+			this->programSplat = gl::compileAndLinkShaders(vertexShaderCode, fragmentShaderCode, { "point" });
 
-			this->locationIterateCounter = glGetUniformLocation(this->programIterate, "counter");
-			this->locationIterateSeed = glGetUniformLocation(this->programIterate, "seed");
+			this->locationSplatCounter = glGetUniformLocation(this->programSplat, "counter");
+			this->locationSplatSeed = glGetUniformLocation(this->programSplat, "seed");
+			this->locationSplatNumMaps = glGetUniformLocation(this->programSplat, "numMaps");
+			this->locationSplatColorScale = glGetUniformLocation(this->programSplat, "colorScale");
+			this->locationSplatSaturation = glGetUniformLocation(this->programSplat, "saturation");
 
 
-			this->compileInitialSetProgram();
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_shader_atomic_counters : enable \n\
 
-			this->reset();
-		}
+				precision highp float;
 
-		void compileInitialSetProgram()
-		{
-			std::vector<glm::ivec2> pixels;
+				layout(binding = 0) uniform usampler2D samplerSet;
 
-			for (const auto& point : this->initialSet.points)
-			{
-				pixels.push_back(this->findBestPixel(glm::ivec2(0), this->size - 1, this->size, this->viewport, point));
-			}
+				layout(binding = 1) uniform samplerBuffer maps;
 
+				layout(binding = 0, offset = 0) uniform atomic_uint sources;
+				layout(binding = 0, offset = 4) uniform atomic_uint written;
+				layout(binding = 0, offset = 8) uniform atomic_uint kept;
 
-			this->textureInitialSet = nullptr;
+				uniform bool countChanges;
+				uniform int numMaps;
 
-			if (this->initialSet.hasType(InitialSet::Type::Image))
-			{
-				this->textureInitialSet = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+				uniform uint counter;
 
-				glBindTexture(GL_TEXTURE_2D, this->textureInitialSet);
+				layout(location = 0) out uint result;
+			);
 
-				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->initialSet.image->width, this->initialSet.image->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, this->initialSet.image->pixels.data());
+			fragmentShaderCode += this->getParametersCode();
 
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+			fragmentShaderCode += CODE(
+				bool covers(const ivec2 index, const int k)
+				{
+					vec4 linear = texelFetch(maps, 3 * k);
+					vec2 offset = texelFetch(maps, 3 * k + 1).xy;
+					vec4 inverseLinear = texelFetch(maps, 3 * k + 2);
 
-				glGenerateMipmap(GL_TEXTURE_2D);
-			}
+					mat2x2 matrix = mat2x2(linear.xy, linear.zw);
+					mat2x2 inverse = mat2x2(inverseLinear.xy, inverseLinear.zw);
 
+					vec2 inverseOffset = -(inverse * offset);
 
-			auto fragmentShaderCode = CODE(\
-				#version 420 core \n\
-				#extension GL_ARB_shader_image_load_store : enable \n\
+					vec2 lower = fromScreen(vec2(index) / size);
+					vec2 upper = fromScreen(vec2(index + 1) / size);
 
-				precision highp float;
+					vec2 corner0 = inverse * lower + inverseOffset;
+					vec2 corner1 = inverse * vec2(upper.x, lower.y) + inverseOffset;
+					vec2 corner2 = inverse * vec2(lower.x, upper.y) + inverseOffset;
+					vec2 corner3 = inverse * upper + inverseOffset;
 
-				layout(r32ui, binding = 0) uniform uimage2D imageSet;
-				
-				uniform float seed;
+					vec2 minimum = min(min(corner0, corner1), min(corner2, corner3));
+					vec2 maximum = max(max(corner0, corner1), max(corner2, corner3));
 
-				out vec4 color;
-			);
+					ivec2 begin = max(ivec2(floor(toScreen(minimum) * size - 0.5)) - 1, ivec2(0));
+					ivec2 end = min(ivec2(ceil(toScreen(maximum) * size - 0.5)) + 1, size - 1);
 
-			if (this->initialSet.hasType(InitialSet::Type::Image) && this->textureInitialSet)
-			{
-				fragmentShaderCode += CODE(
-					uniform sampler2D samplerInitialSet;
-				);
-			}
+					for (int y = begin.y; y <= end.y; y++)
+					{
+						for (int x = begin.x; x <= end.x; x++)
+						{
+							if ((texelFetch(samplerSet, ivec2(x, y), 0).r & 0x7FFFFFFFu) != counter - 1u)
+							{
+								continue;
+							}
 
-			fragmentShaderCode += "ivec2 size = ivec2(" + std::to_string(size.x) + ", " + std::to_string(size.y) + ");";
+							vec2 pos = fromScreen((vec2(x, y) + 0.5) / size);
 
-			fragmentShaderCode += CODE(
-				float noise(vec2 xy, float seed)
-				{
-					float golden_ratio = 1.61803398874989484820459;
+							if (ivec2(toScreen(matrix * pos + offset) * size) == index)
+							{
+								return true;
+							}
+						}
+					}
 
-					return fract(tan(distance(xy * golden_ratio, xy) * seed) * xy.x);
+					return false;
 				}
 
 				void main()
 				{
-					float random = noise(gl_FragCoord.xy, seed);
+					ivec2 index = ivec2(gl_FragCoord.xy);
 
-					ivec2 pixel = ivec2(gl_FragCoord.xy);
-					vec2 position = gl_FragCoord.xy / vec2(size);
-					
-					float x = position.x;
-					float y = position.y;
-					float pi = 3.1415926535897932384626433832795f;
+					uint value = texelFetch(samplerSet, index, 0).r & 0x7FFFFFFFu;
 
-					float value = 0.0f;
+					bool inSet = false;
+
+					for (int k = 0; k < numMaps && !inSet; k++)
+					{
+						inSet = covers(index, k);
+					}
+
+					if (countChanges)
+					{
+						if (value == counter - 1u)
+						{
+							atomicCounterIncrement(sources);
+						}
+
+						if (inSet)
+						{
+							atomicCounterIncrement(written);
+
+							if (value == counter - 1u)
+							{
+								atomicCounterIncrement(kept);
+							}
+						}
+					}
+
+					result = inSet ? counter : value;
+				}
 			);
 
-			if (this->initialSet.hasType(InitialSet::Type::Distribution))
-			{
-				fragmentShaderCode += "value = max(value, " + this->initialSet.distribution + ");";
-			}
+			this->programGather = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
 
-			if (this->initialSet.hasType(InitialSet::Type::Image) && this->textureInitialSet)
-			{
-				fragmentShaderCode += CODE(
-					vec4 texel = texture(samplerInitialSet, position);
+			this->locationGatherCounter = glGetUniformLocation(this->programGather, "counter");
+			this->locationGatherCountChanges = glGetUniformLocation(this->programGather, "countChanges");
+			this->locationGatherNumMaps = glGetUniformLocation(this->programGather, "numMaps");
 
-					value = max(value, texel.a * (texel.r + texel.g + texel.b) / 3.0);
-				);
-			}
 
-			fragmentShaderCode += CODE(
-					imageStore(imageSet, pixel, uvec4(value > 0.0 ? uint(random <= value) : 0u, 0u, 0u, 0u));
-				);
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_shader_image_load_store : enable \n\
 
-			if (this->initialSet.hasType(InitialSet::Type::Points))
-			{
-				for (const auto& pixel : pixels)
+				precision highp float;
+
+				layout(r32ui, binding = 0) uniform uimage2D image;
+
+				uniform uint counter;
+
+				out vec4 color;
+
+				void main()
 				{
-					fragmentShaderCode += "if (pixel.x == " + std::to_string(pixel.x) + " && pixel.y == " + std::to_string(pixel.y) + ")";
-					fragmentShaderCode += "{";
-					fragmentShaderCode += "   imageStore(imageSet, pixel, uvec4(1u, 0u, 0u, 0u)); ";
-					fragmentShaderCode += "}";
-				}
-			}
+					ivec2 index = ivec2(gl_FragCoord.xy);
+
+					uint value = imageLoad(image, index).r & 0x7FFFFFFFu;
+
+					imageStore(image, index, uvec4(value == counter ? 1u : 0u, 0u, 0u, 0u));
 
-			fragmentShaderCode += CODE(
 					color = vec4(0.0);
 				}
 			);
 
-			this->programInit = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
-
-			this->locationInitSeed = glGetUniformLocation(this->programInit, "seed");
-		}
+			this->programReseed = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
 
-	public:
-		virtual void reset() override
-		{
-			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+			this->locationReseedCounter = glGetUniformLocation(this->programReseed, "counter");
 
-			glViewport(0, 0, this->size.x, this->size.y);
+			this->programFrontier = nullptr;
+			this->programCompact = nullptr;
 
-			glUseProgram(this->programInit);
+			if (!gl::extensionAvailable("GL_ARB_shader_storage_buffer_object"))
+			{
+				return;
+			}
 
-			thread_local auto begin = std::chrono::high_resolution_clock::now();
-			auto end = std::chrono::high_resolution_clock::now();
+			GLint maxVertexImages = 0;
+			GLint maxVertexStorageBlocks = 0;
+			GLint maxFragmentStorageBlocks = 0;
 
-			glUniform1f(this->locationInitSeed, 1.5f + std::sin(static_cast<float>(std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() % 65536)));
+			glGetIntegerv(GL_MAX_VERTEX_IMAGE_UNIFORMS, &maxVertexImages);
+			glGetIntegerv(GL_MAX_VERTEX_SHADER_STORAGE_BLOCKS, &maxVertexStorageBlocks);
+			glGetIntegerv(GL_MAX_FRAGMENT_SHADER_STORAGE_BLOCKS, &maxFragmentStorageBlocks);
 
-			if (this->initialSet.hasType(InitialSet::Type::Image) && this->textureInitialSet)
+			if (maxVertexImages < 1 || maxVertexStorageBlocks < 3 || maxFragmentStorageBlocks < 3)
 			{
-				glBindTexture(GL_TEXTURE_2D, this->textureInitialSet);
+				return;
 			}
 
-			glBindImageTexture(0, this->textureSet, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32UI);
+			auto headerCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_shader_storage_buffer_object : enable \n\
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+				precision highp float;
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+				layout(r32ui, binding = 0) uniform uimage2D image;
 
-			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+				layout(binding = 0) uniform samplerBuffer maps;
 
-			this->counter = 1;
-		}
+				layout(std430, binding = 0) readonly buffer Sources
+				{
+					uint sources[];
+				};
 
-		virtual void iterate(const std::int32_t iterations) override
-		{
-			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+				layout(std430, binding = 1) writeonly buffer Targets
+				{
+					uint targets[];
+				};
 
-			for (std::int32_t i = 0; i < iterations; i++)
-			{
-				glViewport(0, 0, this->size.x, this->size.y);
+				layout(std430, binding = 2) buffer Counts
+				{
+					uint count;
+					uint instanceCount;
+					uint first;
+					uint baseInstance;
+					uint kept;
+				};
 
-				glUseProgram(this->programIterate);
+				uniform int numMaps;
 
-				glUniform1ui(this->locationIterateCounter, ++this->counter);
+				uniform uint counter;
+				uniform uint previous;
+			);
 
-				thread_local auto begin = std::chrono::high_resolution_clock::now();
-				auto end = std::chrono::high_resolution_clock::now();
+			headerCode += this->getParametersCode();
 
-				glUniform1f(this->locationIterateSeed, 1.5f + std::sin(static_cast<float>(std::chrono::duration_cast<std::chrono::milliseconds>(end - begin).count() % 65536)));
+			vertexShaderCode = headerCode + ifs::getVariationGLSLFunction(this->variationMask) + CODE(
+				void plot(const vec2 pos, const int k)
+				{
+					vec4 linear = texelFetch(maps, 3 * k);
+					vec2 offset = texelFetch(maps, 3 * k + 1).xy;
 
-				glBindImageTexture(0, this->textureSet, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+					ivec2 index = ivec2(toScreen(vary(mat2x2(linear.xy, linear.zw) * pos + offset, k)) * size);
 
-				glDrawArrays(GL_TRIANGLES, 0, 6);
+					if (any(lessThan(index, ivec2(0))) || any(greaterThanEqual(index, size)))
+					{
+						return;
+					}
 
-				glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
-			}
+					uint oldValue = imageAtomicExchange(image, index, counter) & 0x7FFFFFFFu;
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
-		}
+					if (oldValue != counter)
+					{
+						targets[atomicAdd(count, 1u)] = uint(index.y * size.x + index.x);
 
-		virtual void render(const glm::ivec2& resolution, const Viewport& viewport) override
-		{
-			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+						if (oldValue == previous)
+						{
+							atomicAdd(kept, 1u);
+						}
+					}
+				}
 
-			glViewport(0, 0, this->size.x, this->size.y);
+				void main()
+				{
+					uint source = sources[gl_VertexID];
 
-			glUseProgram(this->programColor);
+					vec2 pos = fromScreen((vec2(source % uint(size.x), source / uint(size.x)) + 0.5) / size);
 
-			glUniform1ui(this->locationColorCounter, this->counter);
+					for (int k = 0; k < numMaps; k++)
+					{
+						plot(pos, k);
+					}
 
-			glUniform3fv(this->locationColorPrimary, 1, reinterpret_cast<const GLfloat*>(&this->colorPrimary));
-			glUniform3fv(this->locationColorSecondary, 1, reinterpret_cast<const GLfloat*>(&this->colorSecondary));
-			glUniform3fv(this->locationColorBackground, 1, reinterpret_cast<const GLfloat*>(&this->colorBackground));
+					gl_Position = vec4(0.0, 0.0, 0.0, 1.0);
+				}
+			);
 
-			glUniform1i(this->locationFalloff, static_cast<GLint>(this->falloff));
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
 
-			glBindImageTexture(0, this->textureSet, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
+				out vec4 color;
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+				void main()
+				{
+					color = vec4(0.0);
+				}
+			);
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			this->programFrontier = gl::compileAndLinkShaders(vertexShaderCode, fragmentShaderCode);
 
-			glBindTexture(GL_TEXTURE_2D, this->textureColor);
-			
-			glGenerateMipmap(GL_TEXTURE_2D);
+			this->locationFrontierCounter = glGetUniformLocation(this->programFrontier, "counter");
+			this->locationFrontierPrevious = glGetUniformLocation(this->programFrontier, "previous");
+			this->locationFrontierNumMaps = glGetUniformLocation(this->programFrontier, "numMaps");
 
+			fragmentShaderCode = headerCode + CODE(
+				out vec4 color;
 
-			glViewport(0, 0, resolution.x, resolution.y);
+				void main()
+				{
+					ivec2 index = ivec2(gl_FragCoord.xy);
 
-			glUseProgram(this->programRender);
+					if ((imageLoad(image, index).r & 0x7FFFFFFFu) == counter)
+					{
+						targets[atomicAdd(count, 1u)] = uint(index.y * size.x + index.x);
+					}
 
-			glUniform2iv(this->locationSize, 1, reinterpret_cast<const GLint*>(&this->size));
-			glUniform2iv(this->locationResolution, 1, reinterpret_cast<const GLint*>(&resolution));
+					color = vec4(0.0);
+				}
+			);
 
-			glm::vec4 fViewport(this->viewport.viewport);
-			glm::vec4 fViewportRequested(viewport.viewport);
+			this->programCompact = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
 
-			glUniform4fv(this->locationViewport, 1, reinterpret_cast<const GLfloat*>(&fViewport));
-			glUniform4fv(this->locationViewportRequested, 1, reinterpret_cast<const GLfloat*>(&fViewportRequested));
+			this->locationCompactCounter = glGetUniformLocation(this->programCompact, "counter");
+		}
 
-			glBindTexture(GL_TEXTURE_2D, this->textureColor);
-			glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, reinterpret_cast<GLfloat*>(&this->colorBackground));
+		static std::vector<glm::vec4> getMapEntries(const std::vector<AffineTransform>& affineTransforms, const bool probabilistic)
+		{
+			std::vector<ifs::Map> maps = toMaps(affineTransforms);
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+			std::shared_ptr<ifs::AliasTable> aliasTable;
+
+			if (probabilistic)
+			{
+				aliasTable = std::make_shared<ifs::AliasTable>(ifs::getWeights(maps));
+			}
+
+			std::vector<glm::vec4> entries;
+
+			for (std::size_t i = 0; i < affineTransforms.size(); i++)
+			{
+				const auto& affineTransform = affineTransforms[i];
+
+				ifs::Map inverse = glm::abs(maps[i].getDeterminant()) > 0.0f ? maps[i].getInverse() : ifs::Map(glm::mat2x2(0.0f));
+
+				entries.push_back(glm::vec4(affineTransform.matrix[0], affineTransform.matrix[1]));
+				entries.push_back(glm::vec4(affineTransform.offset, aliasTable ? aliasTable->getProbability(i) : 1.0f, static_cast<float>(aliasTable ? aliasTable->getAlias(i) : i)));
+				entries.push_back(glm::vec4(inverse.a, inverse.c, inverse.b, inverse.d));
+			}
+
+			return entries;
 		}
 
-		virtual Viewport getPreferredViewport() const override
+		static std::vector<glm::vec4> getVariationEntries(const std::vector<AffineTransform>& affineTransforms)
 		{
-			return this->viewport;
+			std::vector<glm::vec4> entries;
+
+			for (const auto& affineTransform : affineTransforms)
+			{
+				std::array<float, 4 * ((ifs::numVariations + 3) / 4)> weights = { };
+
+				std::copy(affineTransform.variations.weights.begin(), affineTransform.variations.weights.end(), weights.begin());
+
+				for (std::size_t i = 0; i < weights.size(); i += 4)
+				{
+					entries.push_back(glm::vec4(weights[i], weights[i + 1], weights[i + 2], weights[i + 3]));
+				}
+			}
+
+			return entries;
 		}
-		
-		virtual void options() override
+
+		static void uploadMaps(RAIIWrapper<GLuint>& buffer, RAIIWrapper<GLuint>& texture, const std::vector<glm::vec4>& entries)
 		{
-			if (ImGui::InputInt2("Size", reinterpret_cast<int*>(&this->size)))
+			bool created = !buffer;
+
+			if (created)
 			{
-				this->setup();
+				buffer = RAIIWrapper<GLuint>(glCreate(Buffer)(), glDelete(Buffer));
+				texture = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
 			}
 
-			fractals::Fractal::options();
+			glBindBuffer(GL_TEXTURE_BUFFER, buffer);
 
-			if (ImGui::TreeNode("Affine Contraction Mappings"))
+			glBufferData(GL_TEXTURE_BUFFER, glm::max(entries.size(), std::size_t(1)) * sizeof(glm::vec4), entries.data(), GL_DYNAMIC_DRAW);
+
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+			if (created)
 			{
-				ImGui::BeginGroup();
+				glBindTexture(GL_TEXTURE_BUFFER, texture);
 
-				bool changed = false;
+				glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, buffer);
 
-				if (ImGui::BeginMenu("Load Configration"))
-				{
-					Fractal fractal;
+				glBindTexture(GL_TEXTURE_BUFFER, 0);
+			}
+		}
 
-					if (ImGui::MenuItem("Barnsley Fern"))
-					{
-						fractal = this->createBarnsleyFern();
-					}
-					if (ImGui::MenuItem("Sierpinski Triangle"))
-					{
-						fractal = this->createSierpinskiTriangle();
-					}
-					if (ImGui::MenuItem("Maple Leaf"))
-					{
-						fractal = this->createMapleLeaf();
-					}
+		void setup()
+		{
+			this->textureSet = nullptr;
+			this->textureSetBuffered = nullptr;
+			this->textureSetPacked = nullptr;
+			this->framebufferIterate = nullptr;
+			this->framebufferGather = nullptr;
+			this->textureColor = nullptr;
+			this->textureDensity = nullptr;
+			this->textureDensityColors = nullptr;
+			this->textureDensityColorsHigh = nullptr;
+			this->textureDensityMaximum = nullptr;
+			this->framebufferDensity = nullptr;
+			this->textureBits = nullptr;
+			this->textureBitsPrevious = nullptr;
+			this->textureDirtyTiles = nullptr;
+			this->framebufferBits = nullptr;
+			this->boxCounter = nullptr;
+
+			this->sparseActive = this->sparse && gl::extensionAvailable("GL_ARB_sparse_texture") && gl::extensionAvailable("GL_ARB_sparse_texture2");
+
+			this->pagesSet.clear();
+			this->pagesSetBuffered.clear();
+			this->pagesColor.clear();
+
+			if (this->sparseActive)
+			{
+				glGetInternalformativ(GL_TEXTURE_2D, GL_R32UI, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &this->pageSizeSet.x);
+				glGetInternalformativ(GL_TEXTURE_2D, GL_R32UI, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &this->pageSizeSet.y);
 
-					if (fractal.affineTransforms.size() > 0)
-					{
-						this->viewport = fractal.viewport;
-						this->affineTransforms = fractal.affineTransforms;
+				glGetInternalformativ(GL_TEXTURE_2D, GL_RGBA8, GL_VIRTUAL_PAGE_SIZE_X_ARB, 1, &this->pageSizeColor.x);
+				glGetInternalformativ(GL_TEXTURE_2D, GL_RGBA8, GL_VIRTUAL_PAGE_SIZE_Y_ARB, 1, &this->pageSizeColor.y);
+			}
 
-						changed = true;
-					}
+			this->framebufferIterate = RAIIWrapper<GLuint>(glCreate(Framebuffer)(), glDelete(Framebuffer));
 
-					ImGui::EndMenu();
-				}
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
 
-				ImGui::Separator();
+			this->textureColor = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
 
-				glm::vec4 viewport = this->viewport.viewport;
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
 
-				changed |= ImGui::InputFloat4("Viewport", reinterpret_cast<float*>(&viewport));
+			if (this->sparseActive)
+			{
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
 
-				for (std::size_t i = 0; i < this->affineTransforms.size(); )
-				{
-					ImGui::Separator();
+				glTexStorage2D(GL_TEXTURE_2D, 1, GL_RGBA8, size.x, size.y);
+			}
+			else
+			{
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			}
 
-					float values[8] = {
-						this->affineTransforms[i].matrix[0][0],
-						this->affineTransforms[i].matrix[0][1],
-						this->affineTransforms[i].offset[0],
-						this->affineTransforms[i].matrix[1][0],
-						this->affineTransforms[i].matrix[1][1],
-						this->affineTransforms[i].offset[1],
-						this->affineTransforms[i].p,
-						this->affineTransforms[i].p,
-					};
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, this->sparseActive ? GL_LINEAR : GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 
-					changed |= ImGui::SliderFloat3(("##" + std::to_string(3 * i + 0)).c_str(), values, -2.0f, 2.0f);
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->textureColor, 0);
 
-					ImGui::SameLine();
+			GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
 
-					changed |= ImGui::SliderFloat2(("##" + std::to_string(3 * i + 1)).c_str(), values + 6, 0.0f, 1.0f);
+			glDrawBuffers(1, drawBuffers);
 
-					changed |= ImGui::SliderFloat3(("##" + std::to_string(3 * i + 2)).c_str(), values + 3, -2.0f, 2.0f);
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				throw std::runtime_error("GL-Error: Framebuffer not completed.");
+			}
 
-					ImGui::SameLine();
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-					bool remove = ImGui::Button(("Remove##" + std::to_string(i)).c_str());
 
-					changed |= remove;
+			this->bufferFrontier = nullptr;
+			this->bufferFrontierBuffered = nullptr;
 
-					if (remove)
-					{
-						this->affineTransforms.erase(this->affineTransforms.begin() + i);
-					}
-					else
-					{
-						this->affineTransforms[i].matrix[0][0] = values[0];
-						this->affineTransforms[i].matrix[0][1] = values[1];
-						this->affineTransforms[i].offset[0] = values[2];
-						this->affineTransforms[i].matrix[1][0] = values[3];
-						this->affineTransforms[i].matrix[1][1] = values[4];
-						this->affineTransforms[i].offset[1] = values[5];
-						this->affineTransforms[i].p = values[6];
+			this->updateMaps();
+		}
 
-						i++;
-					}
-				}
+		RAIIWrapper<GLuint> createSetTexture() const
+		{
+			auto texture = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
 
-				ImGui::Separator();
+			glBindTexture(GL_TEXTURE_2D, texture);
 
-				if (ImGui::Button("Add"))
-				{
-					this->affineTransforms.push_back(AffineTransform());
-				}
+			if (this->sparseActive)
+			{
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_SPARSE_ARB, GL_TRUE);
 
-				if (changed)
-				{
-					this->viewport.viewport = viewport;
+				glTexStorage2D(GL_TEXTURE_2D, 1, GL_R32UI, size.x, size.y);
+			}
+			else
+			{
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, size.x, size.y, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+			}
 
-					this->setup();
-				}
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-				ImGui::EndGroup();
+			return texture;
+		}
 
-				ImGui::TreePop();
-			}
+		std::vector<std::uint8_t> getOccupiedPages(const glm::ivec2& pageSize)
+		{
+			glm::ivec2 numPages = (this->size + pageSize - 1) / pageSize;
 
-			if (ImGui::TreeNode("Colors"))
-			{
-				ImGui::ColorEdit3("Primary Color", reinterpret_cast<float*>(&this->colorPrimary));
-				ImGui::ColorEdit3("Secondary Color", reinterpret_cast<float*>(&this->colorSecondary));
-				ImGui::ColorEdit3("Background Color", reinterpret_cast<float*>(&this->colorBackground));
+			std::vector<std::uint8_t> occupied(std::size_t(numPages.x) * std::size_t(numPages.y), 0);
 
-				ImGui::Checkbox("Falloff", &this->falloff);
+			if (!this->codeTree || !this->codeTree->isValid())
+			{
+				std::fill(occupied.begin(), occupied.end(), 1);
 
-				ImGui::TreePop();
+				return occupied;
 			}
 
-			if (ImGui::TreeNode("Initial Set"))
-			{
-				const char* initialSetTypes[] = { "Points", "Distribution", "Image" };
-
-				int index = this->initialSet.getMostSignificantTypeIndex();
+			glm::dvec4 bounds = this->viewport.viewport;
 
-				if (ImGui::Combo("Type", &index, initialSetTypes, sizeof(initialSetTypes) / sizeof(initialSetTypes[0])))
-				{
-					switch (InitialSet::getTypeFromIndex(index))
-					{
-					case InitialSet::Type::Points:
-					{
-						this->initialSet = InitialSet({ glm::vec2(0.0f) }, "");
+			bounds.y = bounds.x + (bounds.y - bounds.x) * double(numPages.x * pageSize.x) / double(this->size.x);
+			bounds.w = bounds.z + (bounds.w - bounds.z) * double(numPages.y * pageSize.y) / double(this->size.y);
 
-						break;
-					}
-					case InitialSet::Type::Distribution:
-					{
-						this->initialSet = InitialSet();
+			this->codeTree->render(numPages, bounds);
 
-						break;
-					}
-					}
+			this->codeTreeValid = false;
 
-					this->compileInitialSetProgram();
+			std::vector<glm::ivec2> pages;
 
-					this->reset();
+			for (std::int32_t y = 0; y < numPages.y; y++)
+			{
+				for (std::int32_t x = 0; x < numPages.x; x++)
+				{
+					if (this->codeTree->getCoverage().get(x, y))
+					{
+						pages.push_back(glm::ivec2(x, y));
+					}
 				}
+			}
 
-				if (this->initialSet.hasType(InitialSet::Type::Points))
+			if (this->initialSet.hasType(InitialSet::Type::Points))
+			{
+				for (const auto& point : this->initialSet.points)
 				{
-					ImGui::SliderFloat2("Point", reinterpret_cast<float*>(this->initialSet.points.data()), glm::min(this->viewport.left, this->viewport.bottom), glm::max(this->viewport.right, this->viewport.top));
+					pages.push_back(this->findBestPixel(glm::ivec2(0), this->size - 1, this->size, this->viewport, point) / pageSize);
 				}
-				if (this->initialSet.hasType(InitialSet::Type::Distribution))
+			}
+
+			for (const auto& page : pages)
+			{
+				for (std::int32_t y = glm::max(page.y - 1, 0); y <= glm::min(page.y + 1, numPages.y - 1); y++)
 				{
-					std::vector<char> buffer(glm::max(this->initialSet.distribution.size() + 1llu, 1024llu), '\0');
+					for (std::int32_t x = glm::max(page.x - 1, 0); x <= glm::min(page.x + 1, numPages.x - 1); x++)
+					{
+						occupied[std::size_t(y) * std::size_t(numPages.x) + std::size_t(x)] = 1;
+					}
+				}
+			}
 
-					std::copy(this->initialSet.distribution.begin(), this->initialSet.distribution.end(), buffer.begin());
+			return occupied;
+		}
 
-					if (ImGui::InputText("Distribution", buffer.data(), buffer.size()))
-					{
-						this->initialSet.distribution = buffer.data();
+		void commitPages(const RAIIWrapper<GLuint>& texture, const GLenum format, const GLenum type, const glm::ivec2& pageSize, std::vector<std::uint8_t>& committed, const std::vector<std::uint8_t>& occupied)
+		{
+			glm::ivec2 numPages = (this->size + pageSize - 1) / pageSize;
 
-						try
-						{
-							this->compileInitialSetProgram();
+			committed.resize(occupied.size(), 0);
 
-							try
-							{
-								this->reset();
-							}
-							catch (const std::exception&)
-							{
-								throw;
-							}
-						}
-						catch (const std::exception&)
-						{
+			std::vector<std::uint32_t> zeros;
 
-						}
-					}
+			glBindTexture(GL_TEXTURE_2D, texture);
 
-					if (ImGui::BeginMenu("Load Distribution"))
+			for (std::int32_t y = 0; y < numPages.y; y++)
+			{
+				for (std::int32_t x = 0; x < numPages.x; x++)
+				{
+					std::size_t i = std::size_t(y) * std::size_t(numPages.x) + std::size_t(x);
+
+					if (committed[i] != occupied[i])
 					{
-						static std::vector<std::pair<std::string, std::string>> distributions = {
-							{ "Sinus", "sin(pi * x) * sin(pi * y) / 4" },
-							{ "Checkerboard", "sin(10 * pi * x) * sin(10 * pi * y) / 4" },
-							{ "Rectangle", "0.25 < x && x < 0.75 && 0.25 < y && y < 0.75 ? 1.0 : 0.0" },
-							{ "Ellipse", "(pow(x - 0.5, 2.0) + pow(y - 0.5, 2.0)) < 0.25 ? 1.0 : 0.0" },
-						};
+						glm::ivec2 offset = glm::ivec2(x, y) * pageSize;
+						glm::ivec2 extent = glm::min(pageSize, this->size - offset);
 
-						for (const auto& distribution : distributions)
-						{
-							if (ImGui::MenuItem(distribution.first.c_str()))
-							{
-								this->initialSet.distribution = distribution.second;
+						glTexPageCommitmentARB(GL_TEXTURE_2D, 0, offset.x, offset.y, 0, extent.x, extent.y, 1, occupied[i] ? GL_TRUE : GL_FALSE);
 
-								this->compileInitialSetProgram();
+						if (occupied[i])
+						{
+							zeros.resize(std::size_t(pageSize.x) * std::size_t(pageSize.y), 0u);
 
-								this->reset();
-							}
+							glTexSubImage2D(GL_TEXTURE_2D, 0, offset.x, offset.y, extent.x, extent.y, format, type, zeros.data());
 						}
 
-						ImGui::EndMenu();
+						committed[i] = occupied[i];
 					}
 				}
-				if (this->initialSet.hasType(InitialSet::Type::Image))
-				{
-					ImGui::Text("Drag and Drop an Image.");
-				}
-
-				ImGui::TreePop();
 			}
 		}
 
-		virtual void dropImage(const img::ImagePtr& image) override
+		void updateMaps(const bool warmStart = false)
 		{
-			this->initialSet = InitialSet({ }, "", image);
+			bool probabilistic = false;
 
-			this->compileInitialSetProgram();
+			for (const auto& affineTransform : this->affineTransforms)
+			{
+				probabilistic |= affineTransform.p > 0.0f;
+			}
 
-			this->reset();
-		}
+			std::uint32_t variationMask = ifs::getVariationMask(this->toVariations(this->affineTransforms));
 
-		virtual img::ImagePtr exportImage() const override
-		{
-			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+			if (variationMask != this->variationMask)
+			{
+				this->variationMask = variationMask;
 
-			img::ImagePtr image = img::make(this->size.x, this->size.y);
+				this->compileIterationPrograms();
+			}
 
-			glReadPixels(0, 0, this->size.x, this->size.y, GL_RGBA, GL_UNSIGNED_BYTE, image->pixels.data());
+			this->deterministic = !probabilistic;
+			this->splat = this->engine == Engine::GPU && probabilistic;
+			this->contraction = ifs::getContraction(this->toMaps(this->affineTransforms));
+			this->gatherable = this->deterministic && this->variationMask == 0 && ifs::isGatherable(this->toMaps(this->affineTransforms), this->size, this->viewport.viewport);
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			struct
+			{
+				glm::vec4 viewport;
+				glm::ivec2 size;
+				glm::ivec2 padding;
+			} parameters = { glm::vec4(this->viewport.viewport), this->size, glm::ivec2(0) };
 
-			return image;
-		}
-	};
+			glBindBuffer(GL_UNIFORM_BUFFER, this->bufferParameters);
 
-	class BarnsleyFern : public Affine
-	{
-	public:
-		BarnsleyFern(const glm::ivec2& size) :
-			Affine(size, Affine::createBarnsleyFern())
-		{
+			glBufferData(GL_UNIFORM_BUFFER, sizeof(parameters), &parameters, GL_DYNAMIC_DRAW);
 
-		}
-	};
+			glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-	class SierpinskiTriangle : public Affine
-	{
-	public:
-		SierpinskiTriangle(const glm::ivec2& size) :
-			Affine(size, Affine::createSierpinskiTriangle())
-		{
+			this->uploadMaps(this->bufferMaps, this->textureMaps, this->getMapEntries(this->affineTransforms, probabilistic));
+			this->uploadMaps(this->bufferWeights, this->textureWeights, this->getVariationEntries(this->affineTransforms));
 
-		}
-	};
+			this->fusedDepth = 0;
 
-	class MapleLeaf : public Affine
-	{
-	public:
-		MapleLeaf(const glm::ivec2& size) :
-			Affine(size, Affine::createMapleLeaf())
-		{
 
-		}
-	};
+			if (this->engine == Engine::SetIteration)
+			{
+				this->textureSet = nullptr;
+
+				this->pagesSet.clear();
+			}
+			else if (!this->textureSet)
+			{
+				this->textureSet = this->createSetTexture();
+			}
+
+			if (this->gatherable && !this->textureSetBuffered)
+			{
+				this->textureSetBuffered = this->createSetTexture();
+
+				this->pagesSetBuffered.clear();
+
+				this->framebufferGather = RAIIWrapper<GLuint>(glCreate(Framebuffer)(), glDelete(Framebuffer));
+
+				glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferGather);
+
+				glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->textureSetBuffered, 0);
+
+				GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
+
+				glDrawBuffers(1, drawBuffers);
+
+				if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+				{
+					throw std::runtime_error("GL-Error: Framebuffer not completed.");
+				}
+
+				glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			}
+
+
+			std::shared_ptr<ifs::Hutchinson> previous = warmStart ? this->hutchinson : nullptr;
+
+			this->codeTree = this->affineTransforms.size() > 0 && this->variationMask == 0 ? std::make_shared<ifs::CodeTree>(this->toMaps(this->affineTransforms)) : nullptr;
+			this->codeTreeValid = false;
+
+			if (this->sparseActive)
+			{
+				auto occupied = this->getOccupiedPages(this->pageSizeSet);
+
+				if (this->textureSet)
+				{
+					this->commitPages(this->textureSet, GL_RED_INTEGER, GL_UNSIGNED_INT, this->pageSizeSet, this->pagesSet, occupied);
+				}
+
+				if (this->textureSetBuffered)
+				{
+					this->commitPages(this->textureSetBuffered, GL_RED_INTEGER, GL_UNSIGNED_INT, this->pageSizeSet, this->pagesSetBuffered, occupied);
+				}
+
+				this->commitPages(this->textureColor, GL_RGBA, GL_UNSIGNED_BYTE, this->pageSizeColor, this->pagesColor, this->pageSizeColor == this->pageSizeSet ? occupied : this->getOccupiedPages(this->pageSizeColor));
+			}
+
+			bool colored = this->density && this->densityColored;
+
+			if (this->engine != Engine::ChaosGame || this->affineTransforms.size() == 0)
+			{
+				this->chaosGame = nullptr;
+			}
+			else if (this->chaosGame && this->chaosGame->getSize() == this->size && this->chaosGame->isColored() == colored)
+			{
+				this->chaosGame->setMaps(this->toMaps(this->affineTransforms), this->viewport.viewport, this->toVariations(this->affineTransforms));
+			}
+			else
+			{
+				this->chaosGame = std::make_shared<ifs::ChaosGame>(this->toMaps(this->affineTransforms), this->size, this->viewport.viewport, 0, std::size_t(1) << 30, 0, colored, this->toVariations(this->affineTransforms));
+			}
+
+			if (this->engine != Engine::SetIteration)
+			{
+				this->hutchinson = nullptr;
+			}
+			else if (this->hutchinson && this->hutchinson->getSize() == this->size)
+			{
+				this->hutchinson->setMaps(this->toMaps(this->affineTransforms), this->viewport.viewport);
+
+				this->hutchinson->setIteration(this->iteration);
+			}
+			else
+			{
+				this->hutchinson = std::make_shared<ifs::Hutchinson>(this->toMaps(this->affineTransforms), this->size, this->viewport.viewport);
+
+				this->hutchinson->setIteration(this->iteration);
+			}
+
+			this->setupFrontier();
+
+			if (this->splat)
+			{
+				this->setupSplat();
+			}
+
+			if (warmStart && this->splat && this->splatCapacity > 0)
+			{
+				this->clearDensity();
+
+				this->iterateSplat(ifs::ChaosGame::warmup, false);
+			}
+			else if (warmStart && !this->splat && (this->engine == Engine::GPU || previous))
+			{
+				this->reseed(previous);
+			}
+			else
+			{
+				this->reset();
+			}
+
+			this->setupFusion();
+		}
+
+		void encodeImage(const img::ImagePtr& image)
+		{
+			if (this->collageTask.valid())
+			{
+				this->collageImage = image;
+
+				return;
+			}
+
+			collage::Bitmap target = collage::fromImage(image, this->collageSettings.resolution);
+
+			collage::Settings settings = this->collageSettings;
+
+			this->collageBegin = std::chrono::steady_clock::now();
+
+			this->collageTask = std::async(std::launch::async, [target, settings]()
+			{
+				return collage::Encoder(target, settings).encode();
+			});
+		}
+
+		void updateEncoding()
+		{
+			if (!this->collageTask.valid() || this->collageTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+			{
+				return;
+			}
+
+			this->collageResult = this->collageTask.get();
+
+			this->collageSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - this->collageBegin).count();
+
+			if (this->collageResult.maps.size() > 0)
+			{
+				std::vector<ifs::Map> maps;
+
+				for (const auto& map : this->collageResult.maps)
+				{
+					maps.push_back(collage::transform(map, this->viewport.viewport));
+				}
+
+				this->affineTransforms = this->fromMaps(maps);
+
+				this->updateMaps();
+			}
+
+			if (this->collageImage)
+			{
+				this->encodeImage(this->collageImage);
+
+				this->collageImage = nullptr;
+			}
+		}
+
+		void screen()
+		{
+			auto begin = std::chrono::steady_clock::now();
+
+			screening::Screener screener(this->screeningSettings);
+
+			this->screeningResults = screener.screen();
+
+			this->screeningSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			this->numScreened = this->screeningSettings.numCandidates;
+			this->numScreeningRejected = screener.getNumRejected();
+		}
+
+		void loadScreeningResult(const screening::Result& result)
+		{
+			this->affineTransforms = this->fromMaps(result.maps);
+
+			glm::dvec4 bounds = result.bounds;
+
+			ifs::getBoundingBox(result.maps, bounds);
+
+			this->viewport.viewport = bounds;
+
+			this->updateMaps();
+		}
+
+		void reseed(const std::shared_ptr<ifs::Hutchinson>& previous)
+		{
+			this->countsValid = false;
+			this->isConverged = false;
+
+			this->frontierValid = false;
+
+			if (previous)
+			{
+				this->hutchinson->initialize([&](const std::int32_t y, std::uint64_t* row)
+				{
+					for (std::size_t w = 0; w < this->hutchinson->getWordsPerRow(); w++)
+					{
+						row[w] = previous->getRow(y, w);
+					}
+				});
+
+				this->activeSize = this->hutchinson->getCount();
+
+				this->counter = 1;
+
+				this->uploadSet();
+
+				return;
+			}
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+
+			glViewport(0, 0, this->size.x, this->size.y);
+
+			glUseProgram(this->programReseed);
+
+			glUniform1ui(this->locationReseedCounter, this->counter);
+
+			glBindImageTexture(0, this->textureSet, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT);
+
+			this->activeSize = 0;
+
+			this->counter = 1;
+		}
+
+		void setupFrontier()
+		{
+			this->frontierValid = false;
+
+			if (this->iteration != ifs::Iteration::Frontier || this->engine != Engine::GPU || !this->deterministic || !this->programFrontier || this->sparseActive)
+			{
+				this->bufferFrontier = nullptr;
+				this->bufferFrontierBuffered = nullptr;
+				this->bufferFrontierCounts = nullptr;
+				this->bufferFrontierCountsBuffered = nullptr;
+
+				return;
+			}
+
+			if (this->bufferFrontier)
+			{
+				return;
+			}
+
+			GLuint counts[5] = { 0, 1, 0, 0, 0 };
+
+			for (auto buffer : { &this->bufferFrontier, &this->bufferFrontierBuffered, &this->bufferFrontierCounts, &this->bufferFrontierCountsBuffered })
+			{
+				*buffer = RAIIWrapper<GLuint>(glCreate(Buffer)(), glDelete(Buffer));
+			}
+
+			for (auto buffer : { this->bufferFrontier, this->bufferFrontierBuffered })
+			{
+				glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+
+				glBufferData(GL_SHADER_STORAGE_BUFFER, std::size_t(this->size.x) * std::size_t(this->size.y) * sizeof(GLuint), nullptr, GL_DYNAMIC_COPY);
+			}
+
+			for (auto buffer : { this->bufferFrontierCounts, this->bufferFrontierCountsBuffered })
+			{
+				glBindBuffer(GL_SHADER_STORAGE_BUFFER, buffer);
+
+				glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(counts), counts, GL_DYNAMIC_COPY);
+			}
+
+			glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		}
+
+		std::int32_t setupFusion()
+		{
+			if (!this->fuse || !this->deterministic || this->variationMask != 0 || this->engine != Engine::GPU || this->getIteration() == ifs::Iteration::Gather)
+			{
+				return 1;
+			}
+
+			std::uint64_t pixels = std::uint64_t(this->size.x) * std::uint64_t(this->size.y);
+
+			std::int32_t depth = ifs::getFusionDepth(this->affineTransforms.size(), this->activeSize > 0 ? this->activeSize : pixels, pixels);
+
+			if (depth != this->fusedDepth)
+			{
+				auto compositions = ifs::getCompositions(this->toMaps(this->affineTransforms), depth);
+
+				if (depth > 1)
+				{
+					this->uploadMaps(this->bufferMapsFused, this->textureMapsFused, this->getMapEntries(this->fromMaps(compositions), false));
+				}
+
+				this->fusedDepth = depth;
+				this->numFusedMaps = static_cast<GLint>(compositions.size());
+			}
+
+			return depth;
+		}
+
+		void resetFrontierCounts(const RAIIWrapper<GLuint>& buffer)
+		{
+			GLuint counts[5] = { 0, 1, 0, 0, 0 };
+
+			glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+
+			glBufferSubData(GL_COPY_WRITE_BUFFER, 0, sizeof(counts), counts);
+
+			glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		}
+
+		void compactFrontier()
+		{
+			this->resetFrontierCounts(this->bufferFrontierCounts);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+
+			glViewport(0, 0, this->size.x, this->size.y);
+
+			glUseProgram(this->programCompact);
+
+			glUniform1ui(this->locationCompactCounter, this->counter);
+
+			glBindBufferBase(GL_UNIFORM_BUFFER, 0, this->bufferParameters);
+
+			glBindImageTexture(0, this->textureSet, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
+
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, this->bufferFrontier);
+			glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, this->bufferFrontierCounts);
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+			this->frontierValid = true;
+		}
+
+		void iterateFrontier(const std::int32_t iterations)
+		{
+			if (!this->frontierValid)
+			{
+				this->compactFrontier();
+			}
+
+			std::int32_t fusedDepth = this->setupFusion();
+
+			glEnable(GL_RASTERIZER_DISCARD);
+
+			for (std::int32_t remaining = iterations; remaining > 0; )
+			{
+				std::int32_t depth = remaining >= fusedDepth ? fusedDepth : 1;
+
+				remaining -= depth;
+
+				this->resetFrontierCounts(this->bufferFrontierCountsBuffered);
+
+				glUseProgram(this->programFrontier);
+
+				glUniform1ui(this->locationFrontierPrevious, this->counter);
+
+				glUniform1ui(this->locationFrontierCounter, this->counter += depth);
+
+				glUniform1i(this->locationFrontierNumMaps, depth > 1 ? this->numFusedMaps : static_cast<GLint>(this->affineTransforms.size()));
+
+				glActiveTexture(GL_TEXTURE2);
+				glBindTexture(GL_TEXTURE_BUFFER, this->textureWeights);
+
+				glActiveTexture(GL_TEXTURE0);
+				glBindTexture(GL_TEXTURE_BUFFER, depth > 1 ? this->textureMapsFused : this->textureMaps);
+
+				glBindBufferBase(GL_UNIFORM_BUFFER, 0, this->bufferParameters);
+
+				glBindImageTexture(0, this->textureSet, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, this->bufferFrontier);
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, this->bufferFrontierBuffered);
+				glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, this->bufferFrontierCountsBuffered);
+
+				glBindBuffer(GL_DRAW_INDIRECT_BUFFER, this->bufferFrontierCounts);
+
+				glDrawArraysIndirect(GL_POINTS, nullptr);
+
+				glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+
+				std::swap(this->bufferFrontier, this->bufferFrontierBuffered);
+				std::swap(this->bufferFrontierCounts, this->bufferFrontierCountsBuffered);
+			}
+
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+			glDisable(GL_RASTERIZER_DISCARD);
+
+			if (iterations > 0)
+			{
+				GLuint sources = 0;
+				GLuint counts[5] = { 0, 0, 0, 0, 0 };
+
+				glBindBuffer(GL_COPY_READ_BUFFER, this->bufferFrontierCountsBuffered);
+
+				glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(sources), &sources);
+
+				glBindBuffer(GL_COPY_READ_BUFFER, this->bufferFrontierCounts);
+
+				glGetBufferSubData(GL_COPY_READ_BUFFER, 0, sizeof(counts), counts);
+
+				glBindBuffer(GL_COPY_READ_BUFFER, 0);
+
+				this->frontierSize = counts[0];
+				this->activeSize = counts[0];
+
+				this->updateConvergence(std::uint64_t(sources) + std::uint64_t(counts[0]) - 2 * std::uint64_t(counts[4]));
+			}
+		}
+
+		void renderCodeTree(const glm::ivec2& resolution, const Viewport& viewport)
+		{
+			if (!this->codeTreeValid || resolution != this->codeTreeResolution || viewport.viewport != this->codeTreeViewport.viewport || this->colorPrimary != this->codeTreeColorPrimary || this->colorBackground != this->codeTreeColorBackground)
+			{
+				if (!this->codeTreeValid || resolution != this->codeTreeResolution || viewport.viewport != this->codeTreeViewport.viewport)
+				{
+					this->codeTree->render(resolution, viewport.viewport);
+				}
+
+				auto toTexel = [](const glm::vec3& color)
+				{
+					glm::vec3 bytes = glm::clamp(color, glm::vec3(0.0f), glm::vec3(1.0f)) * 255.0f + 0.5f;
+
+					return std::uint32_t(bytes.x) | (std::uint32_t(bytes.y) << 8) | (std::uint32_t(bytes.z) << 16) | 0xFF000000u;
+				};
+
+				std::uint32_t primary = toTexel(this->colorPrimary);
+				std::uint32_t background = toTexel(this->colorBackground);
+
+				const auto& coverage = this->codeTree->getCoverage();
+
+				std::vector<std::uint32_t> texels(std::size_t(resolution.x) * std::size_t(resolution.y), background);
+
+				for (std::int32_t y = 0; y < resolution.y; y++)
+				{
+					for (std::size_t w = 0; w < coverage.getWordsPerRow(); w++)
+					{
+						for (std::uint64_t word = coverage.getRow(y, w); word != 0; word &= word - 1ull)
+						{
+							texels[std::size_t(y) * std::size_t(resolution.x) + w * 64 + ifs::countTrailingZeros(word)] = primary;
+						}
+					}
+				}
+
+				if (!this->textureCodeTree)
+				{
+					this->textureCodeTree = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+				}
+
+				glBindTexture(GL_TEXTURE_2D, this->textureCodeTree);
+
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, resolution.x, resolution.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, texels.data());
+
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+				this->codeTreeValid = true;
+				this->codeTreeResolution = resolution;
+				this->codeTreeViewport = viewport;
+				this->codeTreeColorPrimary = this->colorPrimary;
+				this->codeTreeColorBackground = this->colorBackground;
+			}
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			glViewport(0, 0, resolution.x, resolution.y);
+
+			glUseProgram(this->programRender);
+
+			glUniform2iv(this->locationSize, 1, reinterpret_cast<const GLint*>(&resolution));
+			glUniform2iv(this->locationResolution, 1, reinterpret_cast<const GLint*>(&resolution));
+
+			glm::vec4 fViewport(viewport.viewport);
+
+			glUniform4fv(this->locationViewport, 1, reinterpret_cast<const GLfloat*>(&fViewport));
+			glUniform4fv(this->locationViewportRequested, 1, reinterpret_cast<const GLfloat*>(&fViewport));
+
+			glUniform3fv(this->locationRenderBackground, 1, reinterpret_cast<const GLfloat*>(&this->colorBackground));
+
+			glBindTexture(GL_TEXTURE_2D, this->textureCodeTree);
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+		}
+
+		void updateDimension()
+		{
+			if (!this->boxCounter)
+			{
+				this->boxCounter = std::make_shared<ifs::BoxCounter>(this->size);
+			}
+
+			this->dimensionValid = true;
+
+			if (this->hutchinson)
+			{
+				this->bitsValid = false;
+
+				this->boxCounter->update([&](const std::int32_t y, std::uint64_t* row)
+				{
+					for (std::size_t w = 0; w < this->hutchinson->getWordsPerRow(); w++)
+					{
+						row[w] = this->hutchinson->getRow(y, w);
+					}
+				});
+
+				return;
+			}
+
+			if (this->chaosGame)
+			{
+				this->bitsValid = false;
+
+				const auto& hits = this->chaosGame->getHits();
+
+				this->boxCounter->update([&](const std::int32_t y, std::uint64_t* row)
+				{
+					const std::uint64_t* hitsRow = hits.data() + std::size_t(y) * std::size_t(this->size.x);
+
+					std::fill(row, row + (this->size.x + 63) / 64, 0ull);
+
+					for (std::int32_t x = 0; x < this->size.x; x++)
+					{
+						row[x >> 6] |= std::uint64_t(hitsRow[x] > 0) << (x & 63);
+					}
+				});
+
+				return;
+			}
+
+			glm::ivec2 packedSize((this->size.x + 31) / 32, this->size.y);
+
+			glm::ivec2 numTiles = this->boxCounter->getNumTiles();
+
+			glm::ivec2 tileSize(ifs::BoxCounter::tileSize / 32, ifs::BoxCounter::tileSize);
+
+			if (!this->textureBits)
+			{
+				std::vector<std::uint32_t> zeros(std::size_t(packedSize.x) * std::size_t(packedSize.y), 0u);
+
+				for (auto texture : { &this->textureBits, &this->textureBitsPrevious })
+				{
+					*texture = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+					glBindTexture(GL_TEXTURE_2D, *texture);
+
+					glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, packedSize.x, packedSize.y, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, zeros.data());
+
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+					glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+				}
+
+				this->textureDirtyTiles = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+				glBindTexture(GL_TEXTURE_2D, this->textureDirtyTiles);
+
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, numTiles.x, numTiles.y, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+				this->framebufferBits = RAIIWrapper<GLuint>(glCreate(Framebuffer)(), glDelete(Framebuffer));
+
+				glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferBits);
+
+				glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->textureBits, 0);
+
+				GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
+
+				glDrawBuffers(1, drawBuffers);
+
+				if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+				{
+					throw std::runtime_error("GL-Error: Framebuffer not completed.");
+				}
+
+				this->bitsValid = false;
+			}
+
+			std::vector<std::uint32_t> dirty(std::size_t(numTiles.x) * std::size_t(numTiles.y), 0u);
+
+			glBindTexture(GL_TEXTURE_2D, this->textureDirtyTiles);
+
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, numTiles.x, numTiles.y, GL_RED_INTEGER, GL_UNSIGNED_INT, dirty.data());
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferBits);
+
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->textureBits, 0);
+
+			glViewport(0, 0, packedSize.x, packedSize.y);
+
+			glUseProgram(this->programPack);
+
+			glUniform1ui(this->locationPackCounter, this->counter);
+			glUniform1i(this->locationPackDensity, static_cast<GLint>(this->splat));
+			glUniform2iv(this->locationPackSize, 1, reinterpret_cast<const GLint*>(&this->size));
+			glUniform2iv(this->locationPackTileSize, 1, reinterpret_cast<const GLint*>(&tileSize));
+
+			glMemoryBarrier(GL_TEXTURE_FETCH_BARRIER_BIT);
+
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, this->textureBitsPrevious);
+
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, this->splat ? this->textureDensity : this->textureSet);
+
+			glBindImageTexture(0, this->textureDirtyTiles, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32UI);
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+
+			glMemoryBarrier(GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+			std::vector<std::uint8_t> dirtyTiles;
+
+			if (this->bitsValid)
+			{
+				glBindTexture(GL_TEXTURE_2D, this->textureDirtyTiles);
+
+				glGetTexImage(GL_TEXTURE_2D, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, dirty.data());
+
+				dirtyTiles.assign(dirty.begin(), dirty.end());
+			}
+
+			std::vector<std::uint32_t> packed;
+
+			std::int32_t packedRow = -1;
+			std::int32_t packedBegin = 0;
+			std::int32_t packedWidth = packedSize.x;
+
+			glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+			this->boxCounter->update([&](const std::int32_t y, std::uint64_t* row)
+			{
+				std::int32_t ty = y / tileSize.y;
+
+				if (ty != packedRow)
+				{
+					packedRow = ty;
+
+					if (dirtyTiles.size() > 0)
+					{
+						const std::uint8_t* dirtyRow = dirtyTiles.data() + std::size_t(ty) * std::size_t(numTiles.x);
+
+						std::int32_t first = numTiles.x;
+						std::int32_t last = 0;
+
+						for (std::int32_t tx = 0; tx < numTiles.x; tx++)
+						{
+							if (dirtyRow[tx])
+							{
+								first = glm::min(first, tx);
+								last = tx;
+							}
+						}
+
+						packedBegin = first * tileSize.x;
+						packedWidth = glm::min(packedSize.x, (last + 1) * tileSize.x) - packedBegin;
+					}
+
+					std::int32_t height = glm::min(packedSize.y, (ty + 1) * tileSize.y) - ty * tileSize.y;
+
+					packed.resize(std::size_t(packedWidth) * std::size_t(height));
+
+					glReadPixels(packedBegin, ty * tileSize.y, packedWidth, height, GL_RED_INTEGER, GL_UNSIGNED_INT, packed.data());
+				}
+
+				const std::uint32_t* packedRowData = packed.data() + std::size_t(y - ty * tileSize.y) * std::size_t(packedWidth);
+
+				for (std::int32_t w = packedBegin / 2; 2 * w < packedBegin + packedWidth; w++)
+				{
+					std::int32_t t = 2 * w - packedBegin;
+
+					row[w] = std::uint64_t(packedRowData[t]) | (t + 1 < packedWidth ? std::uint64_t(packedRowData[t + 1]) << 32 : 0ull);
+				}
+			}, dirtyTiles);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			std::swap(this->textureBits, this->textureBitsPrevious);
+
+			this->bitsValid = true;
+		}
+
+		void setupSplat()
+		{
+			if (!this->textureDensity)
+			{
+				this->createDensityTextures();
+			}
+
+			if (this->splatCapacity == this->splatPoints)
+			{
+				return;
+			}
+
+			for (auto buffer : { &this->bufferSplat, &this->bufferSplatBuffered })
+			{
+				auto texture = buffer == &this->bufferSplat ? &this->textureSplat : &this->textureSplatBuffered;
+
+				*buffer = RAIIWrapper<GLuint>(glCreate(Buffer)(), glDelete(Buffer));
+				*texture = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+				glBindBuffer(GL_TEXTURE_BUFFER, *buffer);
+
+				glBufferData(GL_TEXTURE_BUFFER, std::size_t(this->splatPoints) * sizeof(glm::vec4), nullptr, GL_DYNAMIC_COPY);
+
+				glBindTexture(GL_TEXTURE_BUFFER, *texture);
+
+				glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, *buffer);
+			}
+
+			glBindTexture(GL_TEXTURE_BUFFER, 0);
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+			this->splatCapacity = 0;
+		}
+
+		void resetSplat()
+		{
+			std::vector<glm::vec4> points(this->splatPoints);
+
+			ifs::Random random(this->seed);
+
+			for (auto& point : points)
+			{
+				float x = random.nextFloat();
+				float y = random.nextFloat();
+
+				point = glm::vec4(glm::mix(this->viewport.left, this->viewport.right, double(x)), glm::mix(this->viewport.bottom, this->viewport.top, double(y)), random.nextFloat(), 0.0f);
+			}
+
+			glBindBuffer(GL_TEXTURE_BUFFER, this->bufferSplat);
+
+			glBufferSubData(GL_TEXTURE_BUFFER, 0, points.size() * sizeof(glm::vec4), points.data());
+
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+			this->splatCapacity = this->splatPoints;
+
+			this->clearDensity();
+
+			this->iterateSplat(ifs::ChaosGame::warmup, false);
+		}
+
+		void iterateSplat(const std::int32_t iterations, const bool plot)
+		{
+			auto begin = std::chrono::steady_clock::now();
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+
+			glViewport(0, 0, this->size.x, this->size.y);
+
+			glUseProgram(this->programSplat);
+
+			glUniform1ui(this->locationSplatSeed, this->seed);
+			glUniform1i(this->locationSplatNumMaps, static_cast<GLint>(this->affineTransforms.size()));
+			glUniform1f(this->locationSplatColorScale, densityColorScale);
+			glUniform1ui(this->locationSplatSaturation, densitySaturation);
+
+			glBindBufferBase(GL_UNIFORM_BUFFER, 0, this->bufferParameters);
+
+			glActiveTexture(GL_TEXTURE2);
+			glBindTexture(GL_TEXTURE_BUFFER, this->textureWeights);
+
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_BUFFER, this->textureMaps);
+
+			glBindImageTexture(0, this->textureDensity, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+			glBindImageTexture(1, this->textureDensityColors, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+			glBindImageTexture(2, this->textureDensityMaximum, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+			glBindImageTexture(3, this->textureDensityColorsHigh, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+
+			if (!plot)
+			{
+				glEnable(GL_RASTERIZER_DISCARD);
+			}
+
+			for (std::int32_t i = 0; i < iterations; i++)
+			{
+				glUniform1ui(this->locationSplatCounter, this->counter++);
+
+				glActiveTexture(GL_TEXTURE1);
+				glBindTexture(GL_TEXTURE_BUFFER, this->textureSplat);
+
+				glActiveTexture(GL_TEXTURE0);
+
+				glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, this->bufferSplatBuffered);
+
+				glBeginTransformFeedback(GL_POINTS);
+
+				glDrawArrays(GL_POINTS, 0, this->splatCapacity);
+
+				glEndTransformFeedback();
+
+				glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+
+				std::swap(this->bufferSplat, this->bufferSplatBuffered);
+				std::swap(this->textureSplat, this->textureSplatBuffered);
+			}
+
+			glDisable(GL_RASTERIZER_DISCARD);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			if (!plot || iterations <= 0)
+			{
+				return;
+			}
+
+			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+			GLuint maximum = 0;
+
+			glBindTexture(GL_TEXTURE_2D, this->textureDensityMaximum);
+
+			glGetTexImage(GL_TEXTURE_2D, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, &maximum);
+
+			this->densityMaximum = maximum;
+
+			this->splatCount += std::uint64_t(iterations) * std::uint64_t(this->splatCapacity);
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			if (seconds > 0.0)
+			{
+				this->pointsPerSecond = double(iterations) * double(this->splatCapacity) / seconds;
+			}
+		}
+
+		void createDensityTextures()
+		{
+			this->textureDensity = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+			this->textureDensityColors = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+			this->textureDensityColorsHigh = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+			this->textureDensityMaximum = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+			for (auto texture : { this->textureDensity, this->textureDensityColors, this->textureDensityColorsHigh, this->textureDensityMaximum })
+			{
+				glm::ivec2 size = GLuint(texture) == GLuint(this->textureDensityMaximum) ? glm::ivec2(1) : this->size;
+
+				glBindTexture(GL_TEXTURE_2D, texture);
+
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, size.x, size.y, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			}
+
+			this->framebufferDensity = RAIIWrapper<GLuint>(glCreate(Framebuffer)(), glDelete(Framebuffer));
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferDensity);
+
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->textureDensity, 0);
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, this->textureDensityColors, 0);
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, this->textureDensityColorsHigh, 0);
+
+			GLenum drawBuffers[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+
+			glDrawBuffers(3, drawBuffers);
+
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				throw std::runtime_error("GL-Error: Framebuffer not completed.");
+			}
+
+			this->clearDensity();
+		}
+
+		void clearDensity()
+		{
+			GLuint zeros[4] = { 0, 0, 0, 0 };
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferDensity);
+
+			glClearBufferuiv(GL_COLOR, 0, zeros);
+			glClearBufferuiv(GL_COLOR, 1, zeros);
+			glClearBufferuiv(GL_COLOR, 2, zeros);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			glBindTexture(GL_TEXTURE_2D, this->textureDensityMaximum);
+
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, 1, 1, GL_RED_INTEGER, GL_UNSIGNED_INT, zeros);
+
+			this->densityMaximum = 0;
+			this->splatCount = 0;
+		}
+
+		void uploadHits()
+		{
+			const auto& hits = this->chaosGame->getHits();
+
+			if (this->density)
+			{
+				const auto& colors = this->chaosGame->getColors();
+
+				this->pixels.resize(hits.size());
+
+				std::vector<std::uint32_t> colorSums(colors.size());
+				std::vector<std::uint32_t> colorSumsHigh(colors.size());
+
+				this->densityMaximum = 0;
+
+				for (std::size_t i = 0; i < hits.size(); i++)
+				{
+					this->pixels[i] = static_cast<std::uint32_t>(glm::min(hits[i], std::uint64_t(densitySaturation)));
+
+					this->densityMaximum = glm::max(this->densityMaximum, std::uint64_t(this->pixels[i]));
+				}
+
+				for (std::size_t i = 0; i < colors.size(); i++)
+				{
+					double scale = hits[i] > densitySaturation ? double(densitySaturation) / double(hits[i]) : 1.0;
+
+					std::uint64_t sum = static_cast<std::uint64_t>(colors[i] * scale * double(densityColorScale) + 0.5);
+
+					colorSums[i] = static_cast<std::uint32_t>(sum);
+					colorSumsHigh[i] = static_cast<std::uint32_t>(sum >> 32);
+				}
+
+				if (!this->textureDensity)
+				{
+					this->createDensityTextures();
+				}
+
+				glBindTexture(GL_TEXTURE_2D, this->textureDensity);
+
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->size.x, this->size.y, GL_RED_INTEGER, GL_UNSIGNED_INT, this->pixels.data());
+
+				if (colorSums.size() > 0)
+				{
+					glBindTexture(GL_TEXTURE_2D, this->textureDensityColors);
+
+					glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->size.x, this->size.y, GL_RED_INTEGER, GL_UNSIGNED_INT, colorSums.data());
+
+					glBindTexture(GL_TEXTURE_2D, this->textureDensityColorsHigh);
+
+					glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->size.x, this->size.y, GL_RED_INTEGER, GL_UNSIGNED_INT, colorSumsHigh.data());
+				}
+
+				return;
+			}
+
+			this->pixels.resize(hits.size());
+
+			for (std::size_t i = 0; i < hits.size(); i++)
+			{
+				this->pixels[i] = hits[i] > 0 ? this->counter : 0u;
+			}
+
+			glBindTexture(GL_TEXTURE_2D, this->textureSet);
+
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->size.x, this->size.y, GL_RED_INTEGER, GL_UNSIGNED_INT, this->pixels.data());
+		}
+
+		double getHausdorffBound() const
+		{
+			if (this->contraction >= 1.0f)
+			{
+				return std::numeric_limits<double>::infinity();
+			}
+
+			double diagonal = glm::length(glm::dvec2(this->viewport.right - this->viewport.left, this->viewport.top - this->viewport.bottom));
+
+			return std::pow(double(this->contraction), double(this->counter - 1)) * diagonal;
+		}
+
+		double getPixelSize() const
+		{
+			return glm::max(glm::abs(this->viewport.right - this->viewport.left) / this->size.x, glm::abs(this->viewport.top - this->viewport.bottom) / this->size.y);
+		}
+
+		void updateConvergence(const std::uint64_t changed)
+		{
+			this->numChanged = changed;
+			this->countsValid = true;
+
+			this->isConverged = this->deterministic && (changed == 0 || this->getHausdorffBound() < this->getPixelSize());
+		}
+
+		void uploadSet()
+		{
+			glm::ivec2 packedSize((this->size.x + 31) / 32, this->size.y);
+
+			if (!this->textureSetPacked)
+			{
+				this->textureSetPacked = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+				glBindTexture(GL_TEXTURE_2D, this->textureSetPacked);
+
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, packedSize.x, packedSize.y, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			}
+
+			this->pixels.resize(std::size_t(packedSize.x) * std::size_t(packedSize.y));
+
+			std::size_t wordsPerRow = this->hutchinson->getWordsPerRow();
+
+			for (std::int32_t y = 0; y < this->size.y; y++)
+			{
+				std::uint32_t* row = this->pixels.data() + std::size_t(y) * std::size_t(packedSize.x);
+
+				for (std::size_t w = 0; w < wordsPerRow; w++)
+				{
+					std::uint64_t word = this->hutchinson->getRow(y, w);
+
+					row[2 * w] = static_cast<std::uint32_t>(word);
+
+					if (2 * w + 1 < std::size_t(packedSize.x))
+					{
+						row[2 * w + 1] = static_cast<std::uint32_t>(word >> 32);
+					}
+				}
+			}
+
+			glBindTexture(GL_TEXTURE_2D, this->textureSetPacked);
+
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, packedSize.x, packedSize.y, GL_RED_INTEGER, GL_UNSIGNED_INT, this->pixels.data());
+		}
+
+		void initializeSet()
+		{
+			std::shared_ptr<formula::Program> program;
+
+			if (this->distributionExpression)
+			{
+				program = std::make_shared<formula::Program>(this->distributionExpression->compileProgram());
+			}
+
+			std::vector<std::uint32_t> rowOffsets(this->size.y + 1, 0u);
+			std::vector<std::int32_t> rowPoints;
+
+			if (this->initialSet.hasType(InitialSet::Type::Points))
+			{
+				std::vector<glm::ivec2> pixels(this->initialSet.points.size());
+
+				std::int32_t numThreads = this->hutchinson->getNumThreads();
+
+				std::size_t chunk = (pixels.size() + numThreads - 1) / numThreads;
+
+				ifs::parallel(numThreads, [&](const std::int32_t t)
+				{
+					for (std::size_t i = glm::min(pixels.size(), t * chunk); i < glm::min(pixels.size(), (t + 1) * chunk); i++)
+					{
+						pixels[i] = this->findBestPixel(glm::ivec2(0), this->size - 1, this->size, this->viewport, this->initialSet.points[i]);
+					}
+				});
+
+				for (const auto& pixel : pixels)
+				{
+					rowOffsets[pixel.y + 1]++;
+				}
+
+				for (std::int32_t y = 0; y < this->size.y; y++)
+				{
+					rowOffsets[y + 1] += rowOffsets[y];
+				}
+
+				std::vector<std::uint32_t> cursors(rowOffsets.begin(), rowOffsets.end() - 1);
+
+				rowPoints.resize(pixels.size());
+
+				for (const auto& pixel : pixels)
+				{
+					rowPoints[cursors[pixel.y]++] = pixel.x;
+				}
+			}
+
+			img::ImagePtr image = this->initialSet.hasType(InitialSet::Type::Image) ? this->initialSet.image : nullptr;
+
+			this->hutchinson->initialize([&](const std::int32_t y, std::uint64_t* row)
+			{
+				std::vector<double> xs(this->size.x);
+				std::vector<double> ys(this->size.x, (double(y) + 0.5) / double(this->size.y));
+				std::vector<double> values(this->size.x, 0.0);
+
+				for (std::int32_t x = 0; x < this->size.x; x++)
+				{
+					xs[x] = (double(x) + 0.5) / double(this->size.x);
+				}
+
+				if (program)
+				{
+					program->evaluate({ xs.data(), ys.data() }, { nullptr, nullptr }, this->size.x, values.data(), nullptr);
+				}
+
+				if (image && image->width > 0 && image->height > 0)
+				{
+					std::size_t iy = glm::min(image->height - 1, static_cast<std::size_t>(ys[0] * image->height));
+
+					for (std::int32_t x = 0; x < this->size.x; x++)
+					{
+						std::size_t ix = glm::min(image->width - 1, static_cast<std::size_t>(xs[x] * image->width));
+
+						std::uint32_t texel = static_cast<std::uint32_t>(image->pixels[iy * image->width + ix]);
+
+						double r = (texel & 0xFF) / 255.0;
+						double g = ((texel >> 8) & 0xFF) / 255.0;
+						double b = ((texel >> 16) & 0xFF) / 255.0;
+						double a = ((texel >> 24) & 0xFF) / 255.0;
+
+						values[x] = glm::max(values[x], a * (r + g + b) / 3.0);
+					}
+				}
+
+				for (std::int32_t x = 0; x < this->size.x; x++)
+				{
+					if (values[x] > 0.0 && rng::random2(static_cast<std::uint32_t>(y * this->size.x + x), 0u, this->seed).x <= values[x])
+					{
+						row[x >> 6] |= 1ull << (x & 63);
+					}
+				}
+
+				for (std::uint32_t i = rowOffsets[y]; i < rowOffsets[y + 1]; i++)
+				{
+					row[rowPoints[i] >> 6] |= 1ull << (rowPoints[i] & 63);
+				}
+			});
+		}
+
+		void compileInitialSetProgram()
+		{
+			this->textureInitialSet = nullptr;
+
+			if (this->initialSet.hasType(InitialSet::Type::Image))
+			{
+				this->textureInitialSet = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+				glBindTexture(GL_TEXTURE_2D, this->textureInitialSet);
+
+				glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->initialSet.image->width, this->initialSet.image->height, 0, GL_RGBA, GL_UNSIGNED_BYTE, this->initialSet.image->pixels.data());
+
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+				glGenerateMipmap(GL_TEXTURE_2D);
+			}
+
+
+			auto fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_shader_image_load_store : enable \n\
+
+				precision highp float;
+
+				layout(r32ui, binding = 0) uniform uimage2D imageSet;
+				
+				uniform uint seed;
+
+				out vec4 color;
+			);
+
+			fragmentShaderCode += rng::getGLSLFunctions();
+
+			if (this->initialSet.hasType(InitialSet::Type::Image) && this->textureInitialSet)
+			{
+				fragmentShaderCode += CODE(
+					uniform sampler2D samplerInitialSet;
+				);
+			}
+
+			std::shared_ptr<formula::Expression> distribution;
+
+			this->distributionError = "";
+
+			if (this->initialSet.hasType(InitialSet::Type::Distribution))
+			{
+				distribution = formula::Expression::parse(this->initialSet.distribution, { formula::Variable("x", true), formula::Variable("y", true) }, this->distributionError);
+			}
+
+			this->distributionExpression = distribution;
+
+			if (distribution)
+			{
+				fragmentShaderCode += formula::Expression::getGLSLFunctions(false);
+				fragmentShaderCode += distribution->compileGLSL("distribution", false, false);
+			}
+
+			fragmentShaderCode += this->getParametersCode();
+
+			fragmentShaderCode += CODE(
+				void main()
+				{
+					ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+					float random = random2(uint(pixel.y * size.x + pixel.x), 0u, seed).x;
+
+					vec2 position = gl_FragCoord.xy / vec2(size);
+					
+					float x = position.x;
+					float y = position.y;
+					float pi = 3.1415926535897932384626433832795f;
+
+					float value = 0.0f;
+			);
+
+			if (distribution)
+			{
+				fragmentShaderCode += "value = max(value, distribution(x, y));";
+			}
+
+			if (this->initialSet.hasType(InitialSet::Type::Image) && this->textureInitialSet)
+			{
+				fragmentShaderCode += CODE(
+					vec4 texel = texture(samplerInitialSet, position);
+
+					value = max(value, texel.a * (texel.r + texel.g + texel.b) / 3.0);
+				);
+			}
+
+			fragmentShaderCode += CODE(
+					imageStore(imageSet, pixel, uvec4(value > 0.0 ? uint(random <= value) : 0u, 0u, 0u, 0u));
+				);
+
+			fragmentShaderCode += CODE(
+					color = vec4(0.0);
+				}
+			);
+
+			this->programInit = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationInitSeed = glGetUniformLocation(this->programInit, "seed");
+
+			this->bufferInitialPoints = nullptr;
+			this->textureInitialPoints = nullptr;
+			this->programInitPoints = nullptr;
+
+			if (!this->initialSet.hasType(InitialSet::Type::Points))
+			{
+				return;
+			}
+
+			this->bufferInitialPoints = RAIIWrapper<GLuint>(glCreate(Buffer)(), glDelete(Buffer));
+			this->textureInitialPoints = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+			glBindBuffer(GL_TEXTURE_BUFFER, this->bufferInitialPoints);
+
+			glBufferData(GL_TEXTURE_BUFFER, this->initialSet.points.size() * sizeof(glm::vec2), this->initialSet.points.data(), GL_STATIC_DRAW);
+
+			glBindTexture(GL_TEXTURE_BUFFER, this->textureInitialPoints);
+
+			glTexBuffer(GL_TEXTURE_BUFFER, GL_RG32F, this->bufferInitialPoints);
+
+			glBindTexture(GL_TEXTURE_BUFFER, 0);
+			glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+			auto vertexShaderCode = CODE(\
+				#version 420 core \n\
+
+				precision highp float;
+
+				layout(binding = 0) uniform samplerBuffer points;
+			);
+
+			vertexShaderCode += this->getParametersCode();
+
+			vertexShaderCode += CODE(
+				void main()
+				{
+					vec2 pixel = clamp(floor(toScreen(texelFetch(points, gl_VertexID).xy) * vec2(size)), vec2(0.0), vec2(size - 1));
+
+					gl_Position = vec4((pixel + 0.5) / vec2(size) * 2.0 - 1.0, 0.0, 1.0);
+				}
+			);
+
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_shader_image_load_store : enable \n\
+
+				layout(r32ui, binding = 0) uniform uimage2D imageSet;
+
+				out vec4 color;
+
+				void main()
+				{
+					imageStore(imageSet, ivec2(gl_FragCoord.xy), uvec4(1u, 0u, 0u, 0u));
+
+					color = vec4(0.0);
+				}
+			);
+
+			this->programInitPoints = gl::compileAndLinkShaders(vertexShaderCode, fragmentShaderCode);
+		}
+
+	public:
+		virtual void reset() override
+		{
+			this->countsValid = false;
+			this->isConverged = false;
+			this->dimensionValid = false;
+
+			this->activeSize = this->initialSet.getType() == InitialSet::Type::Points ? this->initialSet.points.size() : 0;
+
+			if (this->chaosGame)
+			{
+				this->chaosGame->reset(this->seed);
+
+				this->counter = 1;
+
+				this->uploadHits();
+
+				return;
+			}
+
+			if (this->splat)
+			{
+				this->counter = 1;
+
+				this->resetSplat();
+
+				return;
+			}
+
+			if (this->hutchinson)
+			{
+				this->initializeSet();
+
+				this->counter = 1;
+
+				this->uploadSet();
+
+				return;
+			}
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+
+			glViewport(0, 0, this->size.x, this->size.y);
+
+			glUseProgram(this->programInit);
+
+			glUniform1ui(this->locationInitSeed, this->seed);
+
+			if (this->initialSet.hasType(InitialSet::Type::Image) && this->textureInitialSet)
+			{
+				glBindTexture(GL_TEXTURE_2D, this->textureInitialSet);
+			}
+
+			glBindImageTexture(0, this->textureSet, 0, GL_FALSE, 0, GL_WRITE_ONLY, GL_R32UI);
+
+			glBindBufferBase(GL_UNIFORM_BUFFER, 0, this->bufferParameters);
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+
+			if (this->programInitPoints && this->initialSet.points.size() > 0)
+			{
+				glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT);
+
+				glUseProgram(this->programInitPoints);
+
+				glBindTexture(GL_TEXTURE_BUFFER, this->textureInitialPoints);
+
+				glDrawArrays(GL_POINTS, 0, static_cast<GLsizei>(this->initialSet.points.size()));
+			}
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_TEXTURE_UPDATE_BARRIER_BIT);
+
+			this->counter = 1;
+
+			this->frontierValid = false;
+		}
+
+		void reset(const std::uint32_t seed)
+		{
+			this->seed = seed;
+
+			this->reset();
+		}
+
+		void setIteration(const ifs::Iteration iteration)
+		{
+			this->iteration = iteration;
+
+			if (this->hutchinson)
+			{
+				this->hutchinson->setIteration(this->iteration);
+			}
+
+			this->setupFrontier();
+		}
+
+		ifs::Iteration getIteration() const
+		{
+			if (this->hutchinson)
+			{
+				return this->hutchinson->getIteration();
+			}
+
+			if (this->iteration == ifs::Iteration::Gather && this->gatherable)
+			{
+				return ifs::Iteration::Gather;
+			}
+
+			if (this->iteration == ifs::Iteration::Frontier && this->bufferFrontier)
+			{
+				return ifs::Iteration::Frontier;
+			}
+
+			return ifs::Iteration::Scatter;
+		}
+
+		virtual void iterate(const std::int32_t iterations) override
+		{
+			this->dimensionValid = false;
+
+			if (this->chaosGame)
+			{
+				auto begin = std::chrono::steady_clock::now();
+
+				this->chaosGame->run(std::uint64_t(iterations) * std::uint64_t(this->pointsPerIteration));
+
+				double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+				if (seconds > 0.0)
+				{
+					this->pointsPerSecond = double(iterations) * double(this->pointsPerIteration) / seconds;
+				}
+
+				this->counter++;
+
+				this->uploadHits();
+
+				return;
+			}
+
+			if (this->splat)
+			{
+				this->iterateSplat(iterations, true);
+
+				return;
+			}
+
+			if (this->hutchinson)
+			{
+				for (std::int32_t i = 0; i < iterations; i++)
+				{
+					this->hutchinson->iterate();
+
+					this->counter++;
+				}
+
+				this->updateConvergence(this->hutchinson->getChanged());
+
+				this->uploadSet();
+
+				return;
+			}
+
+			if (this->getIteration() == ifs::Iteration::Frontier)
+			{
+				this->iterateFrontier(iterations);
+
+				return;
+			}
+
+			this->frontierValid = false;
+
+			bool gather = this->getIteration() == ifs::Iteration::Gather;
+
+			std::int32_t fusedDepth = this->setupFusion();
+
+			glBindFramebuffer(GL_FRAMEBUFFER, gather ? this->framebufferGather : this->framebufferIterate);
+
+			for (std::int32_t remaining = iterations; remaining > 0; )
+			{
+				std::int32_t depth = remaining >= fusedDepth ? fusedDepth : 1;
+
+				remaining -= depth;
+
+				glViewport(0, 0, this->size.x, this->size.y);
+
+				bool countChanges = remaining == 0;
+
+				if (gather)
+				{
+					glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->textureSetBuffered, 0);
+
+					glUseProgram(this->programGather);
+
+					glUniform1ui(this->locationGatherCounter, ++this->counter);
+
+					glUniform1i(this->locationGatherCountChanges, countChanges);
+
+					glUniform1i(this->locationGatherNumMaps, static_cast<GLint>(this->affineTransforms.size()));
+				}
+				else
+				{
+					glUseProgram(this->programIterate);
+
+					glUniform1ui(this->locationIteratePrevious, this->counter);
+
+					glUniform1ui(this->locationIterateCounter, this->counter += depth);
+
+					glUniform1i(this->locationIterateCountChanges, countChanges);
+
+					glUniform1i(this->locationIterateNumMaps, depth > 1 ? this->numFusedMaps : static_cast<GLint>(this->affineTransforms.size()));
+				}
+
+				glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, this->bufferCounts);
+
+				glBindBufferBase(GL_UNIFORM_BUFFER, 0, this->bufferParameters);
+
+				if (countChanges)
+				{
+					GLuint zeros[3] = { 0, 0, 0 };
+
+					glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(zeros), zeros);
+				}
+
+				if (gather)
+				{
+					glActiveTexture(GL_TEXTURE1);
+					glBindTexture(GL_TEXTURE_BUFFER, this->textureMaps);
+
+					glActiveTexture(GL_TEXTURE0);
+					glBindTexture(GL_TEXTURE_2D, this->textureSet);
+
+					glDrawArrays(GL_TRIANGLES, 0, 6);
+
+					std::swap(this->textureSet, this->textureSetBuffered);
+
+					glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+					continue;
+				}
+
+				glActiveTexture(GL_TEXTURE2);
+				glBindTexture(GL_TEXTURE_BUFFER, this->textureWeights);
+
+				glActiveTexture(GL_TEXTURE0);
+				glBindTexture(GL_TEXTURE_BUFFER, depth > 1 ? this->textureMapsFused : this->textureMaps);
+
+				glBindImageTexture(0, this->textureSet, 0, GL_FALSE, 0, GL_READ_WRITE, GL_R32UI);
+
+				glDrawArrays(GL_TRIANGLES, 0, 6);
+
+				glMemoryBarrier(GL_SHADER_IMAGE_ACCESS_BARRIER_BIT | GL_TEXTURE_FETCH_BARRIER_BIT | GL_BUFFER_UPDATE_BARRIER_BIT);
+			}
+
+			if (iterations > 0)
+			{
+				GLuint counts[3] = { 0, 0, 0 };
+
+				glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(counts), counts);
+
+				this->activeSize = counts[1];
+
+				this->updateConvergence(std::uint64_t(counts[0]) + std::uint64_t(counts[1]) - 2 * std::uint64_t(counts[2]));
+			}
+
+			glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, 0);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		}
+
+		virtual bool converged() const override
+		{
+			return (this->autoStop && this->isConverged) || (this->codeTreeRender && this->codeTree && this->codeTree->isValid());
+		}
+
+		virtual void render(const glm::ivec2& resolution, const Viewport& viewport) override
+		{
+			this->updateEncoding();
+
+			if (this->codeTreeRender && this->codeTree && this->codeTree->isValid())
+			{
+				this->renderCodeTree(resolution, viewport);
+
+				return;
+			}
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+
+			glViewport(0, 0, this->size.x, this->size.y);
+
+			if (((this->chaosGame && this->density) || this->splat) && this->textureDensity)
+			{
+				glUseProgram(this->programResolve);
+
+				glUniform1f(this->locationResolveLogMaximum, static_cast<float>(std::log1p(double(glm::max(this->densityMaximum, std::uint64_t(1))))));
+				glUniform1f(this->locationResolveColorScale, densityColorScale);
+				glUniform1f(this->locationResolveGamma, this->gamma);
+				glUniform1f(this->locationResolveBrightness, this->brightness);
+				glUniform1i(this->locationResolveColored, static_cast<GLint>(this->chaosGame ? this->chaosGame->isColored() : this->densityColored));
+
+				glUniform3fv(this->locationResolvePrimary, 1, reinterpret_cast<const GLfloat*>(&this->colorPrimary));
+				glUniform3fv(this->locationResolveSecondary, 1, reinterpret_cast<const GLfloat*>(&this->colorSecondary));
+				glUniform3fv(this->locationResolveBackground, 1, reinterpret_cast<const GLfloat*>(&this->colorBackground));
+
+				glActiveTexture(GL_TEXTURE2);
+				glBindTexture(GL_TEXTURE_2D, this->textureDensityColorsHigh);
+
+				glActiveTexture(GL_TEXTURE1);
+				glBindTexture(GL_TEXTURE_2D, this->textureDensityColors);
+
+				glActiveTexture(GL_TEXTURE0);
+				glBindTexture(GL_TEXTURE_2D, this->textureDensity);
+			}
+			else
+			{
+				glUseProgram(this->programColor);
+
+				glUniform1ui(this->locationColorCounter, this->counter);
+
+				glUniform3fv(this->locationColorPrimary, 1, reinterpret_cast<const GLfloat*>(&this->colorPrimary));
+				glUniform3fv(this->locationColorSecondary, 1, reinterpret_cast<const GLfloat*>(&this->colorSecondary));
+				glUniform3fv(this->locationColorBackground, 1, reinterpret_cast<const GLfloat*>(&this->colorBackground));
+
+				glUniform1i(this->locationFalloff, static_cast<GLint>(this->falloff));
+				glUniform1i(this->locationColorPacked, static_cast<GLint>(this->hutchinson != nullptr));
+
+				glBindImageTexture(0, this->hutchinson ? this->textureSetPacked : this->textureSet, 0, GL_FALSE, 0, GL_READ_ONLY, GL_R32UI);
+			}
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			if (!this->sparseActive)
+			{
+				glBindTexture(GL_TEXTURE_2D, this->textureColor);
+
+				glGenerateMipmap(GL_TEXTURE_2D);
+			}
+
+
+			glViewport(0, 0, resolution.x, resolution.y);
+
+			glUseProgram(this->programRender);
+
+			glUniform2iv(this->locationSize, 1, reinterpret_cast<const GLint*>(&this->size));
+			glUniform2iv(this->locationResolution, 1, reinterpret_cast<const GLint*>(&resolution));
+
+			glm::vec4 fViewport(this->viewport.viewport);
+			glm::vec4 fViewportRequested(viewport.viewport);
+
+			glUniform4fv(this->locationViewport, 1, reinterpret_cast<const GLfloat*>(&fViewport));
+			glUniform4fv(this->locationViewportRequested, 1, reinterpret_cast<const GLfloat*>(&fViewportRequested));
+
+			glUniform3fv(this->locationRenderBackground, 1, reinterpret_cast<const GLfloat*>(&this->colorBackground));
+
+			glm::vec4 border(this->colorBackground, 1.0f);
+
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+			glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, reinterpret_cast<GLfloat*>(&border));
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+		}
+
+		virtual Viewport getPreferredViewport() const override
+		{
+			return this->viewport;
+		}
+		
+		virtual void options() override
+		{
+			if (ImGui::InputInt2("Size", reinterpret_cast<int*>(&this->size)))
+			{
+				GLint maxSize = 0;
+
+				glGetIntegerv(this->sparseActive ? GL_MAX_SPARSE_TEXTURE_SIZE_ARB : GL_MAX_TEXTURE_SIZE, &maxSize);
+
+				this->size = glm::clamp(this->size, glm::ivec2(1), glm::ivec2(glm::max(maxSize, 1)));
+
+				this->setup();
+			}
+
+			if (gl::extensionAvailable("GL_ARB_sparse_texture") && gl::extensionAvailable("GL_ARB_sparse_texture2") && ImGui::Checkbox("Sparse Storage", &this->sparse))
+			{
+				this->setup();
+			}
+
+			if (this->sparseActive && (this->engine != Engine::GPU || this->splat || this->dimension))
+			{
+				ImGui::TextColored(ImVec4(1.0f, 0.33f, 0.33f, 1.0f), "Sparse storage only covers GPU set iteration. CPU engines, splatting and dimension estimation allocate the full raster.");
+			}
+
+			const char* engines[] = { "GPU (Set Iteration)", "CPU (Chaos Game)", "CPU (Set Iteration)" };
+
+			int engine = static_cast<int>(this->engine);
+
+			if (ImGui::Combo("Engine", &engine, engines, sizeof(engines) / sizeof(engines[0])))
+			{
+				this->engine = static_cast<Engine>(engine);
+
+				this->updateMaps();
+			}
+
+			ImGui::Checkbox("Stop at Fixpoint", &this->autoStop);
+
+			if (this->engine != Engine::ChaosGame && !this->splat)
+			{
+				const char* iterations[] = { "Scatter", "Gather (Inverse Maps)", "Frontier (Point List)" };
+
+				int iteration = static_cast<int>(this->iteration);
+
+				if (ImGui::Combo("Iteration", &iteration, iterations, sizeof(iterations) / sizeof(iterations[0])))
+				{
+					this->setIteration(static_cast<ifs::Iteration>(iteration));
+				}
+
+				if (this->iteration != this->getIteration())
+				{
+					ImGui::TextColored(ImVec4(1.0f, 0.33f, 0.33f, 1.0f), this->iteration == ifs::Iteration::Gather ? "Gather needs invertible, non-probabilistic maps without variations." : "Frontier needs non-probabilistic maps, dense storage and image and storage buffer access in vertex shaders.");
+				}
+			}
+
+			if (this->engine == Engine::GPU && this->deterministic && this->variationMask == 0)
+			{
+				ImGui::Checkbox("Fuse Generations", &this->fuse);
+			}
+
+			if (this->engine == Engine::SetIteration && this->variationMask != 0)
+			{
+				ImGui::TextColored(ImVec4(1.0f, 0.33f, 0.33f, 1.0f), "CPU set iteration ignores variations.");
+			}
+
+			if (this->engine != Engine::ChaosGame)
+			{
+				ImGui::Checkbox("Warm Start after Edits", &this->warmStart);
+			}
+
+			ImGui::Checkbox("Render Code Tree", &this->codeTreeRender);
+
+			if (this->codeTreeRender && (this->variationMask != 0 || (this->codeTree && !this->codeTree->isValid())))
+			{
+				ImGui::TextColored(ImVec4(1.0f, 0.33f, 0.33f, 1.0f), "Code tree rendering needs contractive maps without variations.");
+			}
+
+			ImGui::Checkbox("Estimate Dimension", &this->dimension);
+
+			int seed = static_cast<int>(this->seed);
+
+			if (ImGui::InputInt("Seed", &seed))
+			{
+				this->reset(static_cast<std::uint32_t>(seed));
+			}
+
+			if (this->engine == Engine::ChaosGame || this->splat)
+			{
+				bool changed = false;
+
+				if (this->splat)
+				{
+					changed |= ImGui::InputInt("Points", &this->splatPoints);
+
+					this->splatPoints = glm::clamp(this->splatPoints, 1, 1 << 24);
+				}
+				else
+				{
+					ImGui::InputInt("Points per Iteration", &this->pointsPerIteration);
+
+					this->pointsPerIteration = glm::max(this->pointsPerIteration, 1);
+
+					changed |= ImGui::Checkbox("Log Density", &this->density);
+				}
+
+				if (this->density || this->splat)
+				{
+					changed |= ImGui::Checkbox("Color by Map", &this->densityColored) && !this->splat;
+
+					ImGui::SliderFloat("Gamma", &this->gamma, 0.5f, 5.0f);
+					ImGui::SliderFloat("Brightness", &this->brightness, 0.1f, 4.0f);
+				}
+
+				if (changed)
+				{
+					this->updateMaps();
+				}
+			}
+
+			fractals::Fractal::options();
+
+			if (ImGui::TreeNode("Affine Contraction Mappings"))
+			{
+				ImGui::BeginGroup();
+
+				bool changed = false;
+
+				bool warmStart = this->warmStart;
+
+				if (ImGui::BeginMenu("Load Configration"))
+				{
+					Fractal fractal;
+
+					if (ImGui::MenuItem("Barnsley Fern"))
+					{
+						fractal = this->createBarnsleyFern();
+					}
+					if (ImGui::MenuItem("Sierpinski Triangle"))
+					{
+						fractal = this->createSierpinskiTriangle();
+					}
+					if (ImGui::MenuItem("Maple Leaf"))
+					{
+						fractal = this->createMapleLeaf();
+					}
+
+					if (fractal.affineTransforms.size() > 0)
+					{
+						this->viewport = fractal.viewport;
+						this->affineTransforms = fractal.affineTransforms;
+
+						changed = true;
+
+						warmStart = false;
+					}
+
+					ImGui::EndMenu();
+				}
+
+				ImGui::Separator();
+
+				glm::vec4 viewport = this->viewport.viewport;
+
+				changed |= ImGui::InputFloat4("Viewport", reinterpret_cast<float*>(&viewport));
+
+				ImGui::Checkbox("Fit Viewport to Attractor", &this->fitViewport);
+
+				ImGui::SameLine();
+
+				bool fit = ImGui::Button("Fit Now");
+
+				if (this->contraction >= 1.0f)
+				{
+					ImGui::TextColored(ImVec4(1.0f, 0.33f, 0.33f, 1.0f), "Maps are not contractive (s = %.3g).", this->contraction);
+				}
+
+				for (std::size_t i = 0; i < this->affineTransforms.size(); )
+				{
+					ImGui::Separator();
+
+					float values[8] = {
+						this->affineTransforms[i].matrix[0][0],
+						this->affineTransforms[i].matrix[0][1],
+						this->affineTransforms[i].offset[0],
+						this->affineTransforms[i].matrix[1][0],
+						this->affineTransforms[i].matrix[1][1],
+						this->affineTransforms[i].offset[1],
+						this->affineTransforms[i].p,
+						this->affineTransforms[i].p,
+					};
+
+					changed |= ImGui::SliderFloat3(("##" + std::to_string(3 * i + 0)).c_str(), values, -2.0f, 2.0f);
+
+					ImGui::SameLine();
+
+					changed |= ImGui::SliderFloat2(("##" + std::to_string(3 * i + 1)).c_str(), values + 6, 0.0f, 1.0f);
+
+					changed |= ImGui::SliderFloat3(("##" + std::to_string(3 * i + 2)).c_str(), values + 3, -2.0f, 2.0f);
+
+					ImGui::SameLine();
+
+					bool remove = ImGui::Button(("Remove##" + std::to_string(i)).c_str());
+
+					changed |= remove;
+
+					if (remove)
+					{
+						this->affineTransforms.erase(this->affineTransforms.begin() + i);
+					}
+					else
+					{
+						if (ImGui::TreeNode(("Variations##" + std::to_string(i)).c_str()))
+						{
+							for (std::int32_t v = 0; v < ifs::numVariations; v++)
+							{
+								changed |= ImGui::SliderFloat((std::string(ifs::getVariationName(static_cast<ifs::Variation>(v))) + "##" + std::to_string(i)).c_str(), &this->affineTransforms[i].variations.weights[v], -1.0f, 1.0f);
+							}
+
+							ImGui::TreePop();
+						}
+
+						this->affineTransforms[i].matrix[0][0] = values[0];
+						this->affineTransforms[i].matrix[0][1] = values[1];
+						this->affineTransforms[i].offset[0] = values[2];
+						this->affineTransforms[i].matrix[1][0] = values[3];
+						this->affineTransforms[i].matrix[1][1] = values[4];
+						this->affineTransforms[i].offset[1] = values[5];
+						this->affineTransforms[i].p = values[6];
+
+						i++;
+					}
+				}
+
+				ImGui::Separator();
+
+				if (ImGui::Button("Add"))
+				{
+					this->affineTransforms.push_back(AffineTransform());
+				}
+
+				if (((changed && this->fitViewport) || fit) && ifs::getVariationMask(this->toVariations(this->affineTransforms)) == 0)
+				{
+					glm::dvec4 bounds;
+
+					if (ifs::getBoundingBox(this->toMaps(this->affineTransforms), bounds))
+					{
+						viewport = glm::vec4(bounds);
+
+						changed = true;
+					}
+				}
+
+				if (changed)
+				{
+					warmStart &= viewport == glm::vec4(this->viewport.viewport);
+
+					this->viewport.viewport = viewport;
+
+					this->updateMaps(warmStart);
+				}
+
+				ImGui::EndGroup();
+
+				ImGui::TreePop();
+			}
+
+			if (ImGui::TreeNode("Colors"))
+			{
+				ImGui::ColorEdit3("Primary Color", reinterpret_cast<float*>(&this->colorPrimary));
+				ImGui::ColorEdit3("Secondary Color", reinterpret_cast<float*>(&this->colorSecondary));
+				ImGui::ColorEdit3("Background Color", reinterpret_cast<float*>(&this->colorBackground));
+
+				ImGui::Checkbox("Falloff", &this->falloff);
+
+				ImGui::TreePop();
+			}
+
+			if (ImGui::TreeNode("Initial Set"))
+			{
+				const char* initialSetTypes[] = { "Points", "Distribution", "Image" };
+
+				int index = this->initialSet.getMostSignificantTypeIndex();
+
+				if (ImGui::Combo("Type", &index, initialSetTypes, sizeof(initialSetTypes) / sizeof(initialSetTypes[0])))
+				{
+					switch (InitialSet::getTypeFromIndex(index))
+					{
+					case InitialSet::Type::Points:
+					{
+						this->initialSet = InitialSet({ glm::vec2(0.0f) }, "");
+
+						break;
+					}
+					case InitialSet::Type::Distribution:
+					{
+						this->initialSet = InitialSet();
+
+						break;
+					}
+					}
+
+					this->compileInitialSetProgram();
+
+					this->reset();
+				}
+
+				if (this->initialSet.hasType(InitialSet::Type::Points))
+				{
+					ImGui::SliderFloat2("Point", reinterpret_cast<float*>(this->initialSet.points.data()), glm::min(this->viewport.left, this->viewport.bottom), glm::max(this->viewport.right, this->viewport.top));
+				}
+				if (this->initialSet.hasType(InitialSet::Type::Distribution))
+				{
+					std::vector<char> buffer(glm::max(this->initialSet.distribution.size() + 1llu, 1024llu), '\0');
+
+					std::copy(this->initialSet.distribution.begin(), this->initialSet.distribution.end(), buffer.begin());
+
+					if (ImGui::InputText("Distribution", buffer.data(), buffer.size()))
+					{
+						this->initialSet.distribution = buffer.data();
+
+						try
+						{
+							this->compileInitialSetProgram();
+
+							try
+							{
+								this->reset();
+							}
+							catch (const std::exception&)
+							{
+								throw;
+							}
+						}
+						catch (const std::exception&)
+						{
+
+						}
+					}
+
+					if (!this->distributionError.empty())
+					{
+						ImGui::TextColored(ImVec4(1.0f, 0.33f, 0.33f, 1.0f), "%s", this->distributionError.c_str());
+					}
+
+					if (ImGui::BeginMenu("Load Distribution"))
+					{
+						static std::vector<std::pair<std::string, std::string>> distributions = {
+							{ "Sinus", "sin(pi * x) * sin(pi * y) / 4" },
+							{ "Checkerboard", "sin(10 * pi * x) * sin(10 * pi * y) / 4" },
+							{ "Rectangle", "0.25 < x && x < 0.75 && 0.25 < y && y < 0.75 ? 1.0 : 0.0" },
+							{ "Ellipse", "(pow(x - 0.5, 2.0) + pow(y - 0.5, 2.0)) < 0.25 ? 1.0 : 0.0" },
+						};
+
+						for (const auto& distribution : distributions)
+						{
+							if (ImGui::MenuItem(distribution.first.c_str()))
+							{
+								this->initialSet.distribution = distribution.second;
+
+								this->compileInitialSetProgram();
+
+								this->reset();
+							}
+						}
+
+						ImGui::EndMenu();
+					}
+				}
+				if (this->initialSet.hasType(InitialSet::Type::Image))
+				{
+					ImGui::Text("Drag and Drop an Image.");
+				}
+
+				ImGui::TreePop();
+			}
+
+			if (ImGui::TreeNode("Collage Encoder"))
+			{
+				ImGui::Checkbox("Encode Dropped Images", &this->encodeDropped);
+
+				if (ImGui::InputInt("Resolution", &this->collageSettings.resolution))
+				{
+					this->collageSettings.resolution = glm::clamp(this->collageSettings.resolution, 16, collage::Bitmap::maxSize);
+				}
+
+				if (ImGui::InputInt("Maximum Maps", &this->collageSettings.maxMaps))
+				{
+					this->collageSettings.maxMaps = glm::clamp(this->collageSettings.maxMaps, 1, 64);
+				}
+
+				if (ImGui::InputInt("Scales", &this->collageSettings.numScales))
+				{
+					this->collageSettings.numScales = glm::clamp(this->collageSettings.numScales, 1, 128);
+				}
+
+				ImGui::DragFloatRange2("Scale", &this->collageSettings.minScale, &this->collageSettings.maxScale, 0.005f, 0.01f, 0.95f);
+
+				ImGui::SliderFloat("Tolerance", &this->collageSettings.tolerance, 0.0f, 0.5f);
+				ImGui::SliderFloat("Coverage", &this->collageSettings.coverage, 0.5f, 1.0f);
+
+				if (this->initialSet.hasType(InitialSet::Type::Image) && ImGui::Button("Encode Image"))
+				{
+					this->encodeImage(this->initialSet.image);
+				}
+
+				if (this->collageTask.valid())
+				{
+					ImGui::Text("Encoding... (%.1f s)", std::chrono::duration<double>(std::chrono::steady_clock::now() - this->collageBegin).count());
+				}
+				else if (this->collageResult.numWindows > 0 && this->collageResult.maps.size() == 0)
+				{
+					ImGui::TextColored(ImVec4(1.0f, 0.33f, 0.33f, 1.0f), "No contraction fits the image within the tolerance.");
+				}
+
+				ImGui::TreePop();
+			}
+
+			if (ImGui::TreeNode("Screening"))
+			{
+				ImGui::InputInt("Candidates", &this->screeningSettings.numCandidates, 1000, 10000);
+				ImGui::InputInt("Results", &this->screeningSettings.numResults);
+				ImGui::InputInt("Resolution##Screening", &this->screeningSettings.resolution);
+				ImGui::InputInt("Seed", &this->screeningSettings.seed);
+
+				ImGui::DragIntRange2("Maps", &this->screeningSettings.minMaps, &this->screeningSettings.maxMaps, 0.1f, 1, 16);
+				ImGui::DragFloatRange2("Scale##Screening", &this->screeningSettings.minScale, &this->screeningSettings.maxScale, 0.005f, 0.05f, 0.99f);
+
+				ImGui::SliderFloat("Shear", &this->screeningSettings.maxShear, 0.0f, 1.0f);
+				ImGui::SliderFloat("Maximum Contraction", &this->screeningSettings.maxContraction, 0.1f, 0.99f);
+				ImGui::SliderFloat("Target Coverage", &this->screeningSettings.targetCoverage, 0.01f, 1.0f);
+				ImGui::SliderFloat("Target Dimension", &this->screeningSettings.targetDimension, 0.5f, 2.0f);
+
+				float weights[3] = { this->screeningSettings.weightCoverage, this->screeningSettings.weightDimension, this->screeningSettings.weightSymmetry };
+
+				if (ImGui::SliderFloat3("Weights (Coverage, Dimension, Symmetry)", weights, 0.0f, 2.0f))
+				{
+					this->screeningSettings.weightCoverage = weights[0];
+					this->screeningSettings.weightDimension = weights[1];
+					this->screeningSettings.weightSymmetry = weights[2];
+				}
+
+				this->screeningSettings.numCandidates = glm::max(this->screeningSettings.numCandidates, 1);
+				this->screeningSettings.numResults = glm::clamp(this->screeningSettings.numResults, 1, 256);
+				this->screeningSettings.resolution = glm::clamp(this->screeningSettings.resolution, 16, 1024);
+
+				if (ImGui::Button("Screen"))
+				{
+					this->screen();
+				}
+
+				for (std::size_t i = 0; i < this->screeningResults.size(); i++)
+				{
+					const screening::Result& result = this->screeningResults[i];
+
+					std::string label = "#" + std::to_string(result.index) + ": " + std::to_string(result.maps.size()) + " Maps##Screening" + std::to_string(i);
+
+					if (ImGui::Selectable(label.c_str()))
+					{
+						this->loadScreeningResult(result);
+					}
+
+					ImGui::SameLine();
+
+					ImGui::Text("Score %.3f (Coverage %.2f, Dimension %.3f, Symmetry %.2f)", result.score, result.coverage, result.dimension, result.symmetry);
+				}
+
+				ImGui::TreePop();
+			}
+		}
+
+		virtual void info() override
+		{
+			if (this->chaosGame)
+			{
+				ImGui::Text("Points: %llu", static_cast<unsigned long long>(this->chaosGame->getNumPoints()));
+				ImGui::Text("Points per Second: %.3g (%d Threads)", this->pointsPerSecond, this->chaosGame->getNumThreads());
+				ImGui::Text("Rasters: %s", this->chaosGame->hasPrivateRasters() ? "Private" : "Shared");
+
+				if (this->density)
+				{
+					ImGui::Text("Maximum Density: %llu Hits", static_cast<unsigned long long>(this->densityMaximum));
+				}
+			}
+
+			if (this->splat)
+			{
+				ImGui::Text("Splatted Points: %llu (%d per Step)", static_cast<unsigned long long>(this->splatCount), this->splatCapacity);
+				ImGui::Text("Points per Second: %.3g", this->pointsPerSecond);
+				ImGui::Text("Maximum Density: %llu Hits", static_cast<unsigned long long>(this->densityMaximum));
+			}
+
+			if (this->dimension)
+			{
+				if (!this->dimensionValid)
+				{
+					this->updateDimension();
+				}
+
+				std::int32_t firstLevel = -1;
+				std::int32_t lastLevel = -1;
+
+				double dimension = this->boxCounter->getDimension(16, &firstLevel, &lastLevel);
+
+				if (std::isfinite(dimension))
+				{
+					ImGui::Text("Box-Counting Dimension: %.4f (Boxes of %d to %d Pixels)", dimension, 1 << firstLevel, 1 << lastLevel);
+				}
+				else
+				{
+					ImGui::Text("Box-Counting Dimension: not enough boxes");
+				}
+
+				ImGui::Text("Changed Pixels since Last Estimate: %llu", static_cast<unsigned long long>(this->boxCounter->getNumChanged()));
+			}
+
+			if (this->numScreened > 0)
+			{
+				ImGui::Text("Screened: %d IFS in %.2f s (%.0f per Minute, %llu rejected)", this->numScreened, this->screeningSeconds, this->numScreened / glm::max(this->screeningSeconds, 1e-6) * 60.0, static_cast<unsigned long long>(this->numScreeningRejected));
+			}
+
+			if (this->collageResult.maps.size() > 0)
+			{
+				ImGui::Text("Collage: %zu Maps, %.1f%% Coverage, Error %.3f (%.0f ms)", this->collageResult.maps.size(), 100.0 * this->collageResult.coverage, this->collageResult.collageError, 1000.0 * this->collageSeconds);
+				ImGui::Text("Collage Windows: %llu compared of %llu dense enough, %llu Candidates", static_cast<unsigned long long>(this->collageResult.numCompared), static_cast<unsigned long long>(this->collageResult.numWindows), static_cast<unsigned long long>(this->collageResult.numCandidates));
+			}
+
+			if (this->hutchinson)
+			{
+				ImGui::Text("Pixels in Set: %llu (%d Threads)", static_cast<unsigned long long>(this->hutchinson->getCount()), this->hutchinson->getNumThreads());
+			}
+
+			if (this->sparseActive)
+			{
+				std::size_t committed = std::count(this->pagesSet.begin(), this->pagesSet.end(), std::uint8_t(1));
+
+				ImGui::Text("Sparse Pages: %zu of %zu committed (%dx%d)", committed, this->pagesSet.size(), this->pageSizeSet.x, this->pageSizeSet.y);
+			}
+
+			if (this->codeTreeRender && this->codeTree && this->codeTree->isValid())
+			{
+				ImGui::Text("Code Tree Nodes: %llu (%llu Culled, %d Threads)", static_cast<unsigned long long>(this->codeTree->getNumNodes()), static_cast<unsigned long long>(this->codeTree->getNumCulled()), this->codeTree->getNumThreads());
+				ImGui::Text("Bounding Ball: (%.3g, %.3g), r = %.3g", this->codeTree->getCenter().x, this->codeTree->getCenter().y, this->codeTree->getRadius());
+			}
+
+			if (!this->chaosGame && !this->splat)
+			{
+				const char* iterations[] = { "Scatter", "Gather", "Frontier" };
+
+				ImGui::Text("Iteration: %s", iterations[static_cast<int>(this->getIteration())]);
+
+				if (this->fuse && this->fusedDepth > 1)
+				{
+					ImGui::Text("Fused Generations: %d (%zu Maps)", this->fusedDepth, static_cast<std::size_t>(this->numFusedMaps));
+				}
+
+				if (this->getIteration() == ifs::Iteration::Frontier)
+				{
+					if (this->hutchinson)
+					{
+						ImGui::Text("Active Words: %llu", static_cast<unsigned long long>(this->hutchinson->getFrontierWords()));
+					}
+					else if (this->frontierValid)
+					{
+						ImGui::Text("Active Points: %llu", static_cast<unsigned long long>(this->frontierSize));
+					}
+				}
+
+				ImGui::Text("Generation: %u", this->counter - 1);
+
+				if (this->countsValid)
+				{
+					ImGui::Text("Changed Pixels: %llu", static_cast<unsigned long long>(this->numChanged));
+				}
+
+				double bound = this->getHausdorffBound();
+
+				if (std::isfinite(bound))
+				{
+					ImGui::Text("Hausdorff Bound: %.3g (%.3g Pixels)", bound, bound / this->getPixelSize());
+				}
+				else
+				{
+					ImGui::Text("Hausdorff Bound: not contractive");
+				}
+
+				if (this->isConverged)
+				{
+					ImGui::Text(this->autoStop ? "Fixpoint reached (stopped)" : "Fixpoint reached");
+				}
+			}
+		}
+
+		virtual void dropImage(const img::ImagePtr& image) override
+		{
+			this->initialSet = InitialSet({ }, "", image);
+
+			this->compileInitialSetProgram();
+
+			if (this->encodeDropped)
+			{
+				this->encodeImage(image);
+			}
+
+			this->reset();
+		}
+
+		virtual img::ImagePtr exportImage() const override
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferIterate);
+
+			img::ImagePtr image = img::make(this->size.x, this->size.y);
+
+			glReadPixels(0, 0, this->size.x, this->size.y, GL_RGBA, GL_UNSIGNED_BYTE, image->pixels.data());
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			if (this->sparseActive)
+			{
+				glm::vec3 bytes = glm::clamp(this->colorBackground, glm::vec3(0.0f), glm::vec3(1.0f)) * 255.0f + 0.5f;
+
+				std::uint32_t background = std::uint32_t(bytes.x) | (std::uint32_t(bytes.y) << 8) | (std::uint32_t(bytes.z) << 16) | 0xFF000000u;
+
+				glm::ivec2 numPages = (this->size + this->pageSizeColor - 1) / this->pageSizeColor;
+
+				for (std::int32_t y = 0; y < this->size.y; y++)
+				{
+					for (std::int32_t x = 0; x < this->size.x; x++)
+					{
+						std::size_t page = std::size_t(y / this->pageSizeColor.y) * std::size_t(numPages.x) + std::size_t(x / this->pageSizeColor.x);
+
+						if (page >= this->pagesColor.size() || !this->pagesColor[page])
+						{
+							image->pixels[std::size_t(y) * std::size_t(this->size.x) + std::size_t(x)] = background;
+						}
+					}
+				}
+			}
+
+			return image;
+		}
+	};
+
+	class BarnsleyFern : public Affine
+	{
+	public:
+		BarnsleyFern(const glm::ivec2& size) :
+			Affine(size, Affine::createBarnsleyFern())
+		{
+
+		}
+	};
+
+	class SierpinskiTriangle : public Affine
+	{
+	public:
+		SierpinskiTriangle(const glm::ivec2& size) :
+			Affine(size, Affine::createSierpinskiTriangle())
+		{
+
+		}
+	};
+
+	class MapleLeaf : public Affine
+	{
+	public:
+		MapleLeaf(const glm::ivec2& size) :
+			Affine(size, Affine::createMapleLeaf())
+		{
+
+		}
+	};
 
 	class Mandelbrot : public Fractal
 	{
 	private:
-		glm::ivec2 resolution;
-		Viewport viewport;
-		std::int32_t oversampling;
+		glm::ivec2 resolution;
+		Viewport viewport;
+		std::int32_t oversampling;
+
+		glm::ivec2 size;
+		GLuint currentIteration;
+
+		RAIIWrapper<GLuint> textureValues;
+		RAIIWrapper<GLuint> textureIterations;
+		RAIIWrapper<GLuint> textureColor;
+
+		std::string formula;
+		std::string formulaError;
+
+		std::int32_t nucleusPeriod;
+		std::int32_t nucleusMaxPeriod;
+		std::string nucleusStatus;
+
+		bool navigationRequested;
+		Viewport navigationViewport;
+
+		RAIIWrapper<GLuint> bufferUnresolved;
+		GLint locationCountUnresolved;
+
+		bool autoStop;
+		std::int32_t convergenceInterval;
+		std::int32_t convergenceChecks;
+		double convergenceThreshold;
+
+		std::int32_t framesSinceCount;
+		std::int32_t stableChecks;
+		GLuint unresolved;
+		bool unresolvedValid;
+		bool isConverged;
+
+		std::chrono::steady_clock::time_point timeMeasured;
+		GLuint iterationsMeasured;
+		double iterationsPerSecond;
+
+		std::string vertexShaderCode;
+
+		RAIIWrapper<GLuint> framebuffer;
+		RAIIWrapper<GLuint> programClear;
+		RAIIWrapper<GLuint> programIterate;
+		GLint locationBound;
+		GLint locationCurrentIteration;
+		GLint locationSize;
+		GLint locationViewport;
+		GLint locationIterationsPerFrame;
+
+		RAIIWrapper<GLuint> textureValuesBuffered;
+		RAIIWrapper<GLuint> textureIterationsBuffered;
+		RAIIWrapper<GLuint> textureColorBuffered;
+
+		RAIIWrapper<GLuint> framebufferBuffered;
+
+		RAIIWrapper<GLuint> programRender;
+		GLint locationResolution;
+
+		RAIIWrapper<GLuint> programUpdate;
+		GLint locationSizeUpdate;
+		GLint locationSizeOldUpdate;
+		GLint locationViewportUpdate;
+		GLint locationViewportOldUpdate;
+
+		static inline RAIIWrapper<GLuint> createTextureValues(const glm::ivec2& size)
+		{
+			RAIIWrapper<GLuint> textureValues(glCreate(Texture)(), glDelete(Texture));
+
+			glBindTexture(GL_TEXTURE_2D, textureValues);
+			
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32UI, size.x, size.y, 0, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+			
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+			return textureValues;
+		}
+
+		static inline RAIIWrapper<GLuint> createTextureIterations(const glm::ivec2& size)
+		{
+			RAIIWrapper<GLuint> textureIterations(glCreate(Texture)(), glDelete(Texture));
+
+			glBindTexture(GL_TEXTURE_2D, textureIterations);
+			
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, size.x, size.y, 0, GL_RG_INTEGER, GL_UNSIGNED_BYTE, nullptr);
+			
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			
+			return textureIterations;
+		}
+
+		static inline RAIIWrapper<GLuint> createTextureColor(const glm::ivec2& size)
+		{
+			RAIIWrapper<GLuint> textureColor = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+			glBindTexture(GL_TEXTURE_2D, textureColor);
+			
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+			return textureColor;
+		}
+
+		static inline RAIIWrapper<GLuint> createFramebuffer(const RAIIWrapper<GLuint>& textureValues, const RAIIWrapper<GLuint>& textureIterations, const RAIIWrapper<GLuint>& textureColor)
+		{
+			RAIIWrapper<GLuint> framebuffer(glCreate(Framebuffer)(), glDelete(Framebuffer));
+
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textureValues, 0);
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, textureIterations, 0);
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, textureColor, 0);
+
+			GLenum drawBuffers[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+
+			glDrawBuffers(3, drawBuffers);
+
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				throw std::runtime_error("GL-Error: Framebuffer not completed.");
+			}
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			return framebuffer;
+		}
+
+		void initialize(const glm::ivec2& resolution, const std::int32_t oversampling)
+		{
+			this->resolution = resolution;
+			this->oversampling = oversampling;
+
+			this->size = resolution * oversampling;
+
+			this->textureValues = this->createTextureValues(this->size);
+
+			this->textureIterations = this->createTextureIterations(this->size);
+
+			this->textureColor = this->createTextureColor(this->size);
+
+			this->framebuffer = this->createFramebuffer(this->textureValues, this->textureIterations, this->textureColor);
+
+			this->reset();
+		}
+
+		void update(const glm::ivec2& resolution, const Viewport& viewport, const std::int32_t oversampling)
+		{
+			glm::ivec2 size = resolution * oversampling;
+
+			RAIIWrapper<GLuint> textureValues = this->textureValuesBuffered;
+
+			RAIIWrapper<GLuint> textureIterations = this->textureIterationsBuffered;
+
+			RAIIWrapper<GLuint> textureColor = this->textureColorBuffered;
+
+			RAIIWrapper<GLuint> framebuffer = this->framebufferBuffered;
+
+			bool valid = textureValues && textureIterations && textureColor && framebuffer;
+
+			if (size != this->size || !valid)
+			{
+				textureValues = this->createTextureValues(size);
+
+				textureIterations = this->createTextureIterations(size);
+
+				textureColor = this->createTextureColor(size);
+
+				framebuffer = this->createFramebuffer(textureValues, textureIterations, textureColor);
+
+				this->textureValuesBuffered = nullptr;
+
+				this->textureIterationsBuffered = nullptr;
+
+				this->textureColorBuffered = nullptr;
+
+				this->framebufferBuffered = nullptr;
+			}
+			
+			if (size == this->size)
+			{
+				this->textureValuesBuffered = this->textureValues;
+
+				this->textureIterationsBuffered = this->textureIterations;
+
+				this->textureColorBuffered = this->textureColor;
+
+				this->framebufferBuffered = this->framebuffer;
+			}
+
+			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+
+			glViewport(0, 0, size.x, size.y);
+
+			glUseProgram(this->programUpdate);
+
+			glUniform2iv(this->locationSizeUpdate, 1, reinterpret_cast<const GLint*>(&size));
+			glUniform2iv(this->locationSizeOldUpdate, 1, reinterpret_cast<const GLint*>(&this->size));
+			glUniform4dv(this->locationViewportUpdate, 1, reinterpret_cast<const GLdouble*>(&viewport));
+			glUniform4dv(this->locationViewportOldUpdate, 1, reinterpret_cast<const GLdouble*>(&this->viewport));
+
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, this->textureIterations);
+
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, this->textureValues);
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			glBindTexture(GL_TEXTURE_2D, textureColor);
+
+			glGenerateMipmap(GL_TEXTURE_2D);
+
+			this->currentIteration = 0;
+
+			this->resetConvergence();
+
+			this->textureValues = textureValues;
+
+			this->textureIterations = textureIterations;
+
+			this->textureColor = textureColor;
+
+			this->framebuffer = framebuffer;
+
+			this->resolution = resolution;
+			this->viewport = viewport;
+			this->oversampling = oversampling;
+
+			this->size = size;
+		}
+
+		void resetConvergence()
+		{
+			this->framesSinceCount = 0;
+			this->stableChecks = 0;
+			this->unresolved = 0;
+			this->unresolvedValid = false;
+			this->isConverged = false;
+
+			this->timeMeasured = std::chrono::steady_clock::now();
+			this->iterationsMeasured = 0;
+		}
+
+		void updateConvergence(const GLuint unresolved)
+		{
+			GLuint pixels = static_cast<GLuint>(this->size.x * this->size.y);
+
+			GLuint threshold = static_cast<GLuint>(this->convergenceThreshold / 100.0 * pixels);
+
+			if (this->unresolvedValid && unresolved < pixels && this->unresolved - glm::min(this->unresolved, unresolved) <= threshold)
+			{
+				this->stableChecks++;
+			}
+			else
+			{
+				this->stableChecks = 0;
+			}
+
+			this->unresolved = unresolved;
+			this->unresolvedValid = true;
+
+			this->isConverged = unresolved <= threshold || this->stableChecks >= this->convergenceChecks;
+		}
+
+		bool compileIterateProgram()
+		{
+			auto expression = formula::Expression::parse(this->formula, { formula::Variable("z"), formula::Variable("c") }, this->formulaError);
+
+			if (!expression)
+			{
+				return false;
+			}
+
+			auto fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_gpu_shader_fp64 : enable \n\
+				#extension GL_ARB_shader_atomic_counters : enable \n\
+
+				precision highp float;
+
+				layout(binding = 0) uniform usampler2D samplerValues;
+				layout(binding = 1) uniform usampler2D samplerIterations;
+
+				layout(binding = 0, offset = 0) uniform atomic_uint unresolved;
+
+				uniform bool countUnresolved;
+
+				uniform double bound;
+				uniform uint currentIteration;
+
+				uniform ivec2 size;
+				uniform dvec4 viewport;
+
+				uniform int iterationsPerFrame;
+
+				layout(location = 0) out uvec4 value;
+				layout(location = 1) out uvec4 iterations;
+				layout(location = 2) out vec4 color;
+			);
+
+			fragmentShaderCode += formula::Expression::getGLSLFunctions(true);
+			fragmentShaderCode += expression->compileGLSL("formula", true, true);
+
+			fragmentShaderCode += CODE(
+				void main()
+				{
+					ivec2 pixel = ivec2(gl_FragCoord.xy);
+
+					uvec4 oldValue = texelFetch(samplerValues, pixel, 0);
+
+					dvec2 z = dvec2(packDouble2x32(oldValue.xy), packDouble2x32(oldValue.zw));
+
+					iterations = texelFetch(samplerIterations, pixel, 0);
+
+					color = vec4(0.0, 0.0, 0.0, 1.0);
+
+					dvec2 c = mix(viewport.xz, viewport.yw, dvec2(gl_FragCoord.xy) / size);
+
+					if (z.x != 1.0 / 0.0)
+					{
+						for (int i = 0; i < iterationsPerFrame; i++)
+						{
+							z = formula(z, c);
+
+							iterations.r++;
+
+							if (z.x * z.x + z.y * z.y > bound * bound)
+							{
+								z.x = 1.0 / 0.0;
+
+								break;
+							}
+						}
+					}
+
+					if (z.x == 1.0 / 0.0)
+					{
+						color.r = pow(sin(float(iterations.r) / 10.0), 2.0);
+					}
+					else if (currentIteration <= iterations.g)
+					{
+						color.r = pow(sin(float(iterations.g) / 10.0), 2.0);
+					}
+
+					if (countUnresolved && z.x != 1.0 / 0.0)
+					{
+						atomicCounterIncrement(unresolved);
+					}
+
+					value.xy = unpackDouble2x32(z.x);
+					value.zw = unpackDouble2x32(z.y);
+				}
+			);
+
+			this->programIterate = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationBound = glGetUniformLocation(this->programIterate, "bound");
+			this->locationCurrentIteration = glGetUniformLocation(this->programIterate, "currentIteration");
+
+			this->locationSize = glGetUniformLocation(this->programIterate, "size");
+			this->locationViewport = glGetUniformLocation(this->programIterate, "viewport");
+
+			this->locationIterationsPerFrame = glGetUniformLocation(this->programIterate, "iterationsPerFrame");
+
+			this->locationCountUnresolved = glGetUniformLocation(this->programIterate, "countUnresolved");
+
+			return true;
+		}
+
+	public:
+		Mandelbrot(const glm::ivec2& resolution, const Viewport& viewport, const std::int32_t oversampling = 2, const std::int32_t iterationsPerFrame = 25) :
+			resolution(resolution), viewport(viewport), oversampling(oversampling), formula("z^2 + c"),
+			nucleusPeriod(0), nucleusMaxPeriod(4096), navigationRequested(false),
+			autoStop(true), convergenceInterval(30), convergenceChecks(3), convergenceThreshold(0.001),
+			iterationsMeasured(0), iterationsPerSecond(0.0)
+		{
+			this->vertexShaderCode = CODE(\
+				#version 420 core \n\
+
+				vec2 vertices[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
+				int indices[6] = int[](0, 1, 2, 1, 2, 3);
+
+				void main()
+				{
+					gl_Position = vec4(vertices[indices[gl_VertexID]] * 2.0 - vec2(1.0), 0.0, 1.0);
+				}
+			);
+
+			gl::requireExtension("GL_ARB_gpu_shader_fp64");
+			gl::requireExtension("GL_ARB_shader_atomic_counters");
+
+			this->bufferUnresolved = RAIIWrapper<GLuint>(glCreate(Buffer)(), glDelete(Buffer));
+
+			glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, this->bufferUnresolved);
+
+			glBufferData(GL_ATOMIC_COUNTER_BUFFER, sizeof(GLuint), nullptr, GL_DYNAMIC_READ);
+
+			glBindBuffer(GL_ATOMIC_COUNTER_BUFFER, 0);
+
+			auto fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_gpu_shader_fp64 : enable \n\
+
+				precision highp float;
+
+				layout(location = 0) out uvec4 value;
+				layout(location = 1) out uvec4 iterations;
+				layout(location = 2) out vec4 color;
+
+				void main()
+				{
+					value = uvec4(0);
+					iterations = uvec4(0);
+					color = vec4(0.0, 0.0, 0.0, 1.0);
+				}
+			);
+
+			this->programClear = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+
+			this->compileIterateProgram();
+
+
+
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
+
+				precision highp float;
+
+				uniform sampler2D sampler;
+
+				uniform ivec2 resolution;
+
+				out vec4 color;
+
+				void main()
+				{
+					vec2 screen = gl_FragCoord.xy / resolution;
+
+					color = texture(sampler, screen);
+				}
+			);
+
+			this->programRender = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationResolution = glGetUniformLocation(this->programRender, "resolution");
+
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
+				#extension GL_ARB_gpu_shader_fp64 : enable \n\
+
+				precision highp float;
+				
+				layout(binding = 0) uniform usampler2D samplerValues;
+				layout(binding = 1) uniform usampler2D samplerIterations;
+
+				uniform ivec2 size;
+				uniform ivec2 sizeOld;
+
+				uniform dvec4 viewport;
+				uniform dvec4 viewportOld;
+
+				layout(location = 0) out uvec4 value;
+				layout(location = 1) out uvec4 iterations;
+				layout(location = 2) out vec4 color;
+
+				void main()
+				{
+					dvec2 screen = dvec2(gl_FragCoord.xy) / size;
+
+					dvec2 pos = mix(viewport.xz, viewport.yw, screen);
+
+					dvec2 screenOld = (pos - viewportOld.xz) / (viewportOld.yw - viewportOld.xz);
+
+					dvec2 fragCoordOld = screenOld * sizeOld;
+
+					ivec2 pixel = ivec2(fragCoordOld);
+
+					uvec4 iterationsOld = texelFetch(samplerIterations, pixel, 0);
+
+					uvec4 oldValue = texelFetch(samplerValues, pixel, 0);
+
+					dvec2 z = dvec2(packDouble2x32(oldValue.xy), packDouble2x32(oldValue.zw));
+
+					value = uvec4(0);
+					iterations = uvec4(0, 0, 0, 0);
+					color = vec4(0.0, 0.0, 0.0, 1.0);
+
+					if (z.x == 1.0 / 0.0)
+					{
+						iterations.g = iterationsOld.r;
+					}
+					else if (iterationsOld.r < iterationsOld.g)
+					{
+						iterations.g = iterationsOld.g;
+					}
+				}
+			);
+
+			this->programUpdate = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationSizeUpdate = glGetUniformLocation(this->programUpdate, "size");
+			this->locationSizeOldUpdate = glGetUniformLocation(this->programUpdate, "sizeOld");
+
+			this->locationViewportUpdate = glGetUniformLocation(this->programUpdate, "viewport");
+			this->locationViewportOldUpdate = glGetUniformLocation(this->programUpdate, "viewportOld");
+
+			this->initialize(resolution, oversampling);
+		}
+
+		virtual void reset() override
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+
+			glViewport(0, 0, this->size.x, this->size.y);
+
+			glUseProgram(this->programClear);
+
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, this->textureIterations);
+
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, this->textureValues);
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+
+			glGenerateMipmap(GL_TEXTURE_2D);
+
+			this->currentIteration = 0;
+
+			this->resetConvergence();
+		}
+
+		virtual void iterate(const std::int32_t iterations) override
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+
+			glViewport(0, 0, this->size.x, this->size.y);
+
+			glUseProgram(this->programIterate);
+
+			glUniform1d(this->locationBound, 2.0);
+			glUniform1ui(this->locationCurrentIteration, this->currentIteration);
+
+			glUniform2iv(this->locationSize, 1, reinterpret_cast<const GLint*>(&this->size));
+			glUniform4dv(this->locationViewport, 1, reinterpret_cast<const GLdouble*>(&this->viewport));
+
+			glUniform1i(this->locationIterationsPerFrame, iterations);
+
+			bool countUnresolved = ++this->framesSinceCount >= this->convergenceInterval;
+
+			glUniform1i(this->locationCountUnresolved, countUnresolved);
+
+			glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, this->bufferUnresolved);
+
+			if (countUnresolved)
+			{
+				GLuint zero = 0;
+
+				glBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), &zero);
+			}
+
+			glActiveTexture(GL_TEXTURE1);
+			glBindTexture(GL_TEXTURE_2D, this->textureIterations);
+
+			glActiveTexture(GL_TEXTURE0);
+			glBindTexture(GL_TEXTURE_2D, this->textureValues);
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+
+			this->currentIteration += iterations;
+
+			this->iterationsMeasured += iterations;
+
+			if (countUnresolved)
+			{
+				GLuint unresolved = 0;
+
+				glMemoryBarrier(GL_BUFFER_UPDATE_BARRIER_BIT);
+
+				glGetBufferSubData(GL_ATOMIC_COUNTER_BUFFER, 0, sizeof(GLuint), &unresolved);
+
+				this->updateConvergence(unresolved);
+
+				this->framesSinceCount = 0;
+
+				auto time = std::chrono::steady_clock::now();
+
+				double seconds = std::chrono::duration<double>(time - this->timeMeasured).count();
+
+				if (seconds > 0.0)
+				{
+					this->iterationsPerSecond = this->iterationsMeasured / seconds;
+				}
+
+				this->timeMeasured = time;
+				this->iterationsMeasured = 0;
+			}
+
+			glBindBufferBase(GL_ATOMIC_COUNTER_BUFFER, 0, 0);
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+
+			glGenerateMipmap(GL_TEXTURE_2D);
+		}
+
+		virtual void render(const glm::ivec2& resolution, const Viewport& viewport) override
+		{
+			glUseProgram(this->programRender);
+
+			glUniform2iv(this->locationResolution, 1, reinterpret_cast<const GLint*>(&resolution));
+
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+
+			if (resolution != this->resolution || viewport.viewport != this->viewport.viewport)
+			{
+				this->update(resolution, viewport, this->oversampling);
+
+				glViewport(0, 0, resolution.x, resolution.y);
+			}
+		}
+
+		virtual Viewport getPreferredViewport() const override
+		{
+			return Viewport(-2.0f, 1.0f, -1.0f, 1.0f);
+		}
+
+		virtual std::int32_t getPreferredIterationsPerFrame() const override
+		{
+			return 10;
+		}
+
+		virtual bool converged() const override
+		{
+			return this->autoStop && this->isConverged;
+		}
+
+		virtual bool navigate(Viewport& viewport) override
+		{
+			if (!this->navigationRequested)
+			{
+				return false;
+			}
+
+			viewport = this->navigationViewport;
+
+			this->navigationRequested = false;
+
+			return true;
+		}
+
+		virtual void options() override
+		{
+			Fractal::options();
+
+			std::int32_t oversampling = this->oversampling;
+
+			ImGui::SliderInt("Oversampling", &oversampling, 1, 16);
+
+			if (this->oversampling != oversampling)
+			{
+				this->update(this->resolution, this->viewport, oversampling);
+			}
+
+			std::vector<char> buffer(glm::max(this->formula.size() + 1llu, 1024llu), '\0');
+
+			std::copy(this->formula.begin(), this->formula.end(), buffer.begin());
+
+			bool changed = ImGui::InputText("Formula", buffer.data(), buffer.size());
+
+			if (changed)
+			{
+				this->formula = buffer.data();
+			}
+
+			if (ImGui::BeginMenu("Load Formula"))
+			{
+				static std::vector<std::pair<std::string, std::string>> formulas = {
+					{ "Mandelbrot", "z^2 + c" },
+					{ "Burning Ship", "(abs(re(z)) + i * abs(im(z)))^2 + c" },
+					{ "Tricorn", "conj(z)^2 + c" },
+					{ "Multibrot 3", "z^3 + c" },
+					{ "Multibrot 4", "z^4 + c" },
+					{ "Celtic", "abs(re(z^2)) + i * im(z^2) + c" },
+				};
+
+				for (const auto& formula : formulas)
+				{
+					if (ImGui::MenuItem(formula.first.c_str()))
+					{
+						this->formula = formula.second;
+
+						changed = true;
+					}
+				}
+
+				ImGui::EndMenu();
+			}
+
+			if (changed)
+			{
+				try
+				{
+					if (this->compileIterateProgram())
+					{
+						this->reset();
+					}
+				}
+				catch (const std::exception& exception)
+				{
+					this->formulaError = exception.what();
+				}
+			}
+
+			if (!this->formulaError.empty())
+			{
+				ImGui::TextColored(ImVec4(1.0f, 0.33f, 0.33f, 1.0f), "%s", this->formulaError.c_str());
+			}
+
+			ImGui::InputInt("Period (0 = Detect)", &this->nucleusPeriod);
+
+			ImGui::InputInt("Max Period", &this->nucleusMaxPeriod);
+
+			this->nucleusPeriod = glm::max(this->nucleusPeriod, 0);
+			this->nucleusMaxPeriod = glm::max(this->nucleusMaxPeriod, 1);
+
+			if (ImGui::Button("Find Minibrot"))
+			{
+				if (!nucleus::isQuadratic(this->formula))
+				{
+					this->nucleusStatus = "Minibrot search requires the formula z^2 + c.";
+				}
+				else
+				{
+					glm::dvec2 center = glm::dvec2(this->viewport.left + this->viewport.right, this->viewport.bottom + this->viewport.top) / 2.0;
+					glm::dvec2 radius = glm::abs(glm::dvec2(this->viewport.right - this->viewport.left, this->viewport.top - this->viewport.bottom)) / 2.0;
+
+					nucleus::Minibrot minibrot;
+
+					if (nucleus::locate(center, radius, this->nucleusMaxPeriod, minibrot, this->nucleusPeriod))
+					{
+						double extent = glm::length(minibrot.size) * 1.5;
+
+						glm::dvec2 half = glm::min(radius.x, radius.y) > 0.0 ? radius * (extent / glm::min(radius.x, radius.y)) : glm::dvec2(extent);
+
+						this->navigationViewport = Viewport(minibrot.nucleus.x - half.x, minibrot.nucleus.x + half.x, minibrot.nucleus.y - half.y, minibrot.nucleus.y + half.y);
+
+						this->navigationRequested = true;
+
+						std::stringstream stream;
+
+						stream << std::setprecision(16) << "Period: " << minibrot.period << std::endl;
+						stream << "Nucleus: " << minibrot.nucleus.x << (minibrot.nucleus.y < 0.0 ? " - " : " + ") << std::abs(minibrot.nucleus.y) << "i" << std::endl;
+						stream << std::setprecision(6) << "Size: " << glm::length(minibrot.size);
+
+						this->nucleusStatus = stream.str();
+					}
+					else if (minibrot.period > 0)
+					{
+						this->nucleusStatus = "Newton iteration did not converge for period " + std::to_string(minibrot.period) + ".";
+					}
+					else
+					{
+						this->nucleusStatus = "No period found in the current view.";
+					}
+				}
+			}
+
+			if (!this->nucleusStatus.empty())
+			{
+				ImGui::Text("%s", this->nucleusStatus.c_str());
+			}
+
+			ImGui::Checkbox("Stop when Converged", &this->autoStop);
+
+			ImGui::SliderInt("Convergence Interval", &this->convergenceInterval, 1, 300);
+			ImGui::SliderInt("Convergence Checks", &this->convergenceChecks, 1, 32);
+
+			ImGui::InputDouble("Convergence Threshold (%)", &this->convergenceThreshold, 0.0, 0.0, "%.6f");
+
+			this->convergenceThreshold = glm::max(this->convergenceThreshold, 0.0);
+		}
+
+		virtual void info() override
+		{
+			double pixels = double(this->size.x) * double(this->size.y);
+
+			ImGui::Text("Iteration: %u", this->currentIteration);
+
+			if (this->unresolvedValid)
+			{
+				ImGui::Text("Unresolved: %u (%.3f%%)", this->unresolved, 100.0 * this->unresolved / pixels);
+
+				ImGui::ProgressBar(static_cast<float>(1.0 - this->unresolved / pixels));
+			}
+
+			ImGui::Text("Iterations per Second: %.1f", this->iterationsPerSecond);
+
+			if (this->isConverged)
+			{
+				ImGui::Text(this->autoStop ? "Converged (stopped)" : "Converged");
+			}
+		}
+
+		virtual img::ImagePtr exportImage() const override
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+			glReadBuffer(GL_COLOR_ATTACHMENT2);
+
+			img::ImagePtr image = img::make(this->size.x, this->size.y);
+
+			glReadPixels(0, 0, this->size.x, this->size.y, GL_RGBA, GL_UNSIGNED_BYTE, image->pixels.data());
+
+			glReadBuffer(GL_COLOR_ATTACHMENT0);
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			return image;
+		}
+	};
+
+	class Julia : public Fractal
+	{
+	private:
+		glm::dvec2 c;
+		std::uint32_t maxHits;
+		std::int32_t nodesPerIteration;
 
 		glm::ivec2 size;
-		GLuint currentIteration;
+		Viewport viewport;
 
-		RAIIWrapper<GLuint> textureValues;
-		RAIIWrapper<GLuint> textureIterations;
-		RAIIWrapper<GLuint> textureColor;
+		std::vector<std::uint32_t> hits;
+		std::vector<glm::dvec2> stack;
+		bool changed;
 
-		RAIIWrapper<GLuint> framebuffer;
-		RAIIWrapper<GLuint> programClear;
-		RAIIWrapper<GLuint> programIterate;
-		GLint locationBound;
-		GLint locationCurrentIteration;
-		GLint locationSize;
+		RAIIWrapper<GLuint> textureSet;
+
+		std::string vertexShaderCode;
+
+		RAIIWrapper<GLuint> framebufferColor;
+		RAIIWrapper<GLuint> programColor;
+		GLint locationColorMaxHits;
+		glm::vec3 colorPrimary;
+		glm::vec3 colorBackground;
+		GLint locationColorPrimary;
+		GLint locationColorBackground;
+
+		RAIIWrapper<GLuint> textureColor;
+		RAIIWrapper<GLuint> programRender;
+		GLint locationResolution;
 		GLint locationViewport;
-		GLint locationIterationsPerFrame;
+		GLint locationViewportRequested;
+
+		static inline glm::dvec2 complexSqrt(const glm::dvec2& z)
+		{
+			double r = glm::length(z);
+
+			double x = std::sqrt(glm::max(0.0, (r + z.x) / 2.0));
+			double y = std::sqrt(glm::max(0.0, (r - z.x) / 2.0));
+
+			return glm::dvec2(x, z.y < 0.0 ? -y : y);
+		}
+
+		glm::dvec2 getRepellingFixpoint() const
+		{
+			glm::dvec2 root = this->complexSqrt(glm::dvec2(1.0 - 4.0 * this->c.x, -4.0 * this->c.y));
+
+			glm::dvec2 z1 = (glm::dvec2(1.0, 0.0) + root) / 2.0;
+			glm::dvec2 z2 = (glm::dvec2(1.0, 0.0) - root) / 2.0;
+
+			return glm::length(z1) >= glm::length(z2) ? z1 : z2;
+		}
+
+		void setup()
+		{
+			double radius = glm::max(2.0, glm::length(this->c));
+
+			this->viewport = Viewport(-radius, radius, -radius, radius);
+
+			this->hits = std::vector<std::uint32_t>(this->size.x * this->size.y);
+
+
+			this->textureSet = nullptr;
+			this->framebufferColor = nullptr;
+			this->textureColor = nullptr;
+
+
+			this->textureSet = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+			glBindTexture(GL_TEXTURE_2D, this->textureSet);
+
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_R32UI, this->size.x, this->size.y, 0, GL_RED_INTEGER, GL_UNSIGNED_INT, nullptr);
+
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+
+
+			this->framebufferColor = RAIIWrapper<GLuint>(glCreate(Framebuffer)(), glDelete(Framebuffer));
+
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferColor);
+
+			this->textureColor = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->size.x, this->size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->textureColor, 0);
+
+			GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
+
+			glDrawBuffers(1, drawBuffers);
+
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				throw std::runtime_error("GL-Error: Framebuffer not completed.");
+			}
+
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+			this->reset();
+		}
+
+	public:
+		Julia(const glm::ivec2& size, const glm::dvec2& c = glm::dvec2(-0.123, 0.745), const std::uint32_t maxHits = 4) :
+			c(c), maxHits(maxHits), nodesPerIteration(1 << 16), size(size), changed(true),
+			colorPrimary(glm::vec3(1.0, 1.0, 1.0)), colorBackground(glm::vec3(0.0, 0.0, 0.0))
+		{
+			this->vertexShaderCode = CODE(\
+				#version 420 core \n\
+
+				vec2 vertices[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
+				int indices[6] = int[](0, 1, 2, 1, 2, 3);
+
+				void main()
+				{
+					gl_Position = vec4(vertices[indices[gl_VertexID]] * 2.0 - vec2(1.0), 0.0, 1.0);
+				}
+			);
+
+			auto fragmentShaderCode = CODE(\
+				#version 420 core \n\
+
+				precision highp float;
+
+				layout(binding = 0) uniform usampler2D samplerSet;
+
+				uniform uint maxHits;
+
+				uniform vec3 colorPrimary;
+				uniform vec3 colorBackground;
+
+				out vec4 color;
+
+				void main()
+				{
+					uint value = texelFetch(samplerSet, ivec2(gl_FragCoord.xy), 0).r;
+
+					if (value > 0u)
+					{
+						color = vec4(mix(colorBackground, colorPrimary, 0.5 + 0.5 * float(min(value, maxHits)) / float(maxHits)), 1.0);
+					}
+					else
+					{
+						color = vec4(colorBackground, 1.0);
+					}
+				}
+			);
+
+			this->programColor = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationColorMaxHits = glGetUniformLocation(this->programColor, "maxHits");
+
+			this->locationColorPrimary = glGetUniformLocation(this->programColor, "colorPrimary");
+			this->locationColorBackground = glGetUniformLocation(this->programColor, "colorBackground");
+
+
+			fragmentShaderCode = CODE(\
+				#version 420 core \n\
+
+				precision highp float;
+
+				uniform sampler2D sampler;
+
+				uniform ivec2 resolution;
+
+				uniform vec4 viewport;
+				uniform vec4 viewportRequested;
+
+				out vec4 color;
+
+				vec2 fromScreen(const vec2 screen, const vec4 viewport)
+				{
+					return viewport.xz + screen * (viewport.yw - viewport.xz);
+				}
+
+				vec2 toScreen(const vec2 pos, const vec4 viewport)
+				{
+					return (pos - viewport.xz) / (viewport.yw - viewport.xz);
+				}
+
+				void main()
+				{
+					vec2 screen = gl_FragCoord.xy / resolution;
+
+					vec2 pos = toScreen(fromScreen(screen, viewportRequested), viewport);
+
+					color = texture(sampler, pos);
+				}
+			);
+
+			this->programRender = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationResolution = glGetUniformLocation(this->programRender, "resolution");
+
+			this->locationViewport = glGetUniformLocation(this->programRender, "viewport");
+			this->locationViewportRequested = glGetUniformLocation(this->programRender, "viewportRequested");
+
+
+			this->setup();
+		}
+
+		virtual void reset() override
+		{
+			std::fill(this->hits.begin(), this->hits.end(), 0u);
+
+			this->stack.clear();
+			this->stack.push_back(this->getRepellingFixpoint());
+
+			this->changed = true;
+		}
+
+		virtual void iterate(const std::int32_t iterations) override
+		{
+			glm::dvec2 scale = glm::dvec2(this->size) / glm::dvec2(this->viewport.right - this->viewport.left, this->viewport.top - this->viewport.bottom);
+
+			for (std::int64_t i = 0; i < std::int64_t(iterations) * this->nodesPerIteration && !this->stack.empty(); i++)
+			{
+				glm::dvec2 z = this->stack.back();
 
-		RAIIWrapper<GLuint> textureValuesBuffered;
-		RAIIWrapper<GLuint> textureIterationsBuffered;
-		RAIIWrapper<GLuint> textureColorBuffered;
+				this->stack.pop_back();
 
-		RAIIWrapper<GLuint> framebufferBuffered;
+				glm::ivec2 pixel = glm::ivec2(glm::floor((z - glm::dvec2(this->viewport.left, this->viewport.bottom)) * scale));
 
-		RAIIWrapper<GLuint> programRender;
-		GLint locationResolution;
+				if (pixel.x < 0 || pixel.y < 0 || pixel.x >= this->size.x || pixel.y >= this->size.y)
+				{
+					continue;
+				}
 
-		RAIIWrapper<GLuint> programUpdate;
-		GLint locationSizeUpdate;
-		GLint locationSizeOldUpdate;
-		GLint locationViewportUpdate;
-		GLint locationViewportOldUpdate;
+				auto& hits = this->hits[pixel.y * this->size.x + pixel.x];
 
-		static inline RAIIWrapper<GLuint> createTextureValues(const glm::ivec2& size)
-		{
-			RAIIWrapper<GLuint> textureValues(glCreate(Texture)(), glDelete(Texture));
+				if (hits >= this->maxHits)
+				{
+					continue;
+				}
 
-			glBindTexture(GL_TEXTURE_2D, textureValues);
-			
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA32UI, size.x, size.y, 0, GL_RGBA_INTEGER, GL_UNSIGNED_BYTE, nullptr);
-			
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+				hits++;
 
-			return textureValues;
-		}
+				glm::dvec2 w = this->complexSqrt(z - this->c);
 
-		static inline RAIIWrapper<GLuint> createTextureIterations(const glm::ivec2& size)
-		{
-			RAIIWrapper<GLuint> textureIterations(glCreate(Texture)(), glDelete(Texture));
+				this->stack.push_back(w);
+				this->stack.push_back(-w);
 
-			glBindTexture(GL_TEXTURE_2D, textureIterations);
-			
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RG32UI, size.x, size.y, 0, GL_RG_INTEGER, GL_UNSIGNED_BYTE, nullptr);
-			
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
-			
-			return textureIterations;
+				this->changed = true;
+			}
 		}
 
-		static inline RAIIWrapper<GLuint> createTextureColor(const glm::ivec2& size)
+		virtual void render(const glm::ivec2& resolution, const Viewport& viewport) override
 		{
-			RAIIWrapper<GLuint> textureColor = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
+			if (this->changed)
+			{
+				glBindTexture(GL_TEXTURE_2D, this->textureSet);
 
-			glBindTexture(GL_TEXTURE_2D, textureColor);
-			
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
-			
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
-			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+				glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->size.x, this->size.y, GL_RED_INTEGER, GL_UNSIGNED_INT, this->hits.data());
 
-			return textureColor;
-		}
+				glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferColor);
 
-		static inline RAIIWrapper<GLuint> createFramebuffer(const RAIIWrapper<GLuint>& textureValues, const RAIIWrapper<GLuint>& textureIterations, const RAIIWrapper<GLuint>& textureColor)
-		{
-			RAIIWrapper<GLuint> framebuffer(glCreate(Framebuffer)(), glDelete(Framebuffer));
+				glViewport(0, 0, this->size.x, this->size.y);
 
-			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+				glUseProgram(this->programColor);
 
-			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, textureValues, 0);
-			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT1, textureIterations, 0);
-			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT2, textureColor, 0);
+				glUniform1ui(this->locationColorMaxHits, this->maxHits);
 
-			GLenum drawBuffers[3] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2 };
+				glUniform3fv(this->locationColorPrimary, 1, reinterpret_cast<const GLfloat*>(&this->colorPrimary));
+				glUniform3fv(this->locationColorBackground, 1, reinterpret_cast<const GLfloat*>(&this->colorBackground));
 
-			glDrawBuffers(3, drawBuffers);
+				glDrawArrays(GL_TRIANGLES, 0, 6);
 
-			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
-			{
-				throw std::runtime_error("GL-Error: Framebuffer not completed.");
+				glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+				glBindTexture(GL_TEXTURE_2D, this->textureColor);
+
+				glGenerateMipmap(GL_TEXTURE_2D);
+
+				this->changed = false;
 			}
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-			return framebuffer;
-		}
+			glViewport(0, 0, resolution.x, resolution.y);
 
-		void initialize(const glm::ivec2& resolution, const std::int32_t oversampling)
-		{
-			this->resolution = resolution;
-			this->oversampling = oversampling;
+			glUseProgram(this->programRender);
 
-			this->size = resolution * oversampling;
+			glUniform2iv(this->locationResolution, 1, reinterpret_cast<const GLint*>(&resolution));
 
-			this->textureValues = this->createTextureValues(this->size);
+			glm::vec4 fViewport(this->viewport.viewport);
+			glm::vec4 fViewportRequested(viewport.viewport);
 
-			this->textureIterations = this->createTextureIterations(this->size);
+			glUniform4fv(this->locationViewport, 1, reinterpret_cast<const GLfloat*>(&fViewport));
+			glUniform4fv(this->locationViewportRequested, 1, reinterpret_cast<const GLfloat*>(&fViewportRequested));
 
-			this->textureColor = this->createTextureColor(this->size);
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+			glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, reinterpret_cast<GLfloat*>(&this->colorBackground));
 
-			this->framebuffer = this->createFramebuffer(this->textureValues, this->textureIterations, this->textureColor);
+			glDrawArrays(GL_TRIANGLES, 0, 6);
+		}
 
-			this->reset();
+		virtual Viewport getPreferredViewport() const override
+		{
+			return this->viewport;
 		}
 
-		void update(const glm::ivec2& resolution, const Viewport& viewport, const std::int32_t oversampling)
+		virtual std::int32_t getPreferredIterationsPerFrame() const override
 		{
-			glm::ivec2 size = resolution * oversampling;
+			return 16;
+		}
 
-			RAIIWrapper<GLuint> textureValues = this->textureValuesBuffered;
+		virtual void options() override
+		{
+			if (ImGui::InputInt2("Size", reinterpret_cast<int*>(&this->size)))
+			{
+				this->size = glm::max(this->size, glm::ivec2(1));
 
-			RAIIWrapper<GLuint> textureIterations = this->textureIterationsBuffered;
+				this->setup();
+			}
 
-			RAIIWrapper<GLuint> textureColor = this->textureColorBuffered;
+			Fractal::options();
 
-			RAIIWrapper<GLuint> framebuffer = this->framebufferBuffered;
+			glm::vec2 c(this->c);
 
-			bool valid = textureValues && textureIterations && textureColor && framebuffer;
+			bool changed = ImGui::InputFloat2("c", reinterpret_cast<float*>(&c));
 
-			if (size != this->size || !valid)
+			if (ImGui::BeginMenu("Load Parameter"))
 			{
-				textureValues = this->createTextureValues(size);
+				static std::vector<std::pair<std::string, glm::vec2>> parameters = {
+					{ "Douady Rabbit", glm::vec2(-0.123f, 0.745f) },
+					{ "Dendrite", glm::vec2(0.0f, 1.0f) },
+					{ "San Marco", glm::vec2(-0.75f, 0.0f) },
+					{ "Siegel Disk", glm::vec2(-0.390541f, -0.586788f) },
+					{ "Airplane", glm::vec2(-1.7549f, 0.0f) },
+				};
+
+				for (const auto& parameter : parameters)
+				{
+					if (ImGui::MenuItem(parameter.first.c_str()))
+					{
+						c = parameter.second;
 
-				textureIterations = this->createTextureIterations(size);
+						changed = true;
+					}
+				}
 
-				textureColor = this->createTextureColor(size);
+				ImGui::EndMenu();
+			}
 
-				framebuffer = this->createFramebuffer(textureValues, textureIterations, textureColor);
+			if (changed)
+			{
+				this->c = glm::dvec2(c);
 
-				this->textureValuesBuffered = nullptr;
+				this->setup();
+			}
 
-				this->textureIterationsBuffered = nullptr;
+			int maxHits = static_cast<int>(this->maxHits);
 
-				this->textureColorBuffered = nullptr;
+			if (ImGui::SliderInt("Max Hits per Pixel", &maxHits, 1, 64))
+			{
+				this->maxHits = static_cast<std::uint32_t>(maxHits);
 
-				this->framebufferBuffered = nullptr;
+				this->reset();
 			}
-			
-			if (size == this->size)
+
+			if (ImGui::TreeNode("Colors"))
 			{
-				this->textureValuesBuffered = this->textureValues;
+				this->changed |= ImGui::ColorEdit3("Primary Color", reinterpret_cast<float*>(&this->colorPrimary));
+				this->changed |= ImGui::ColorEdit3("Background Color", reinterpret_cast<float*>(&this->colorBackground));
 
-				this->textureIterationsBuffered = this->textureIterations;
+				ImGui::TreePop();
+			}
+		}
+	};
 
-				this->textureColorBuffered = this->textureColor;
+	class JuliaAtlas : public Fractal
+	{
+	public:
+		enum class Backend : int
+		{
+			GPU = 0,
+			CPU = 1,
+		};
 
-				this->framebufferBuffered = this->framebuffer;
-			}
+	private:
+		glm::ivec2 grid;
+		std::int32_t tileSize;
+		Viewport parameterViewport;
+		Viewport juliaViewport;
+		Viewport viewportRequested;
+		std::int32_t maxIterations;
+		Backend backend;
+
+		std::string formula;
+		std::string formulaError;
+		std::shared_ptr<formula::Expression> expression;
 
-			glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+		glm::ivec2 size;
+		bool changed;
 
-			glViewport(0, 0, size.x, size.y);
+		std::string vertexShaderCode;
 
-			glUseProgram(this->programUpdate);
+		RAIIWrapper<GLuint> textureColor;
+		RAIIWrapper<GLuint> framebufferColor;
+
+		RAIIWrapper<GLuint> programAtlas;
+		GLint locationGrid;
+		GLint locationTileSize;
+		GLint locationParameterViewport;
+		GLint locationJuliaViewport;
+		GLint locationMaxIterations;
+		GLint locationBound;
 
-			glUniform2iv(this->locationSizeUpdate, 1, reinterpret_cast<const GLint*>(&size));
-			glUniform2iv(this->locationSizeOldUpdate, 1, reinterpret_cast<const GLint*>(&this->size));
-			glUniform4dv(this->locationViewportUpdate, 1, reinterpret_cast<const GLdouble*>(&viewport));
-			glUniform4dv(this->locationViewportOldUpdate, 1, reinterpret_cast<const GLdouble*>(&this->viewport));
+		RAIIWrapper<GLuint> programRender;
+		GLint locationResolution;
+		GLint locationViewport;
+		GLint locationViewportRequested;
 
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, this->textureIterations);
+		void setup()
+		{
+			this->size = this->grid * this->tileSize;
 
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, this->textureValues);
+			this->framebufferColor = nullptr;
+			this->textureColor = nullptr;
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			this->framebufferColor = RAIIWrapper<GLuint>(glCreate(Framebuffer)(), glDelete(Framebuffer));
 
-			glBindTexture(GL_TEXTURE_2D, textureColor);
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferColor);
 
-			glGenerateMipmap(GL_TEXTURE_2D);
+			this->textureColor = RAIIWrapper<GLuint>(glCreate(Texture)(), glDelete(Texture));
 
-			this->currentIteration = 0;
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
 
-			this->textureValues = textureValues;
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, this->size.x, this->size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
 
-			this->textureIterations = textureIterations;
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+			glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
 
-			this->textureColor = textureColor;
+			glFramebufferTexture(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, this->textureColor, 0);
 
-			this->framebuffer = framebuffer;
+			GLenum drawBuffers[1] = { GL_COLOR_ATTACHMENT0 };
 
-			this->resolution = resolution;
-			this->viewport = viewport;
-			this->oversampling = oversampling;
+			glDrawBuffers(1, drawBuffers);
 
-			this->size = size;
-		}
+			if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+			{
+				throw std::runtime_error("GL-Error: Framebuffer not completed.");
+			}
 
-	public:
-		Mandelbrot(const glm::ivec2& resolution, const Viewport& viewport, const std::int32_t oversampling = 2, const std::int32_t iterationsPerFrame = 25) :
-			resolution(resolution), viewport(viewport), oversampling(oversampling)
-		{
-			auto vertexShaderCode = CODE(\
-				#version 420 core \n\
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
-				vec2 vertices[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
-				int indices[6] = int[](0, 1, 2, 1, 2, 3);
+			this->reset();
+		}
 
-				void main()
-				{
-					gl_Position = vec4(vertices[indices[gl_VertexID]] * 2.0 - vec2(1.0), 0.0, 1.0);
-				}
-			);
+		bool compileAtlasProgram()
+		{
+			auto expression = formula::Expression::parse(this->formula, { formula::Variable("z"), formula::Variable("c") }, this->formulaError);
 
-			gl::requireExtension("GL_ARB_gpu_shader_fp64");
+			if (!expression)
+			{
+				return false;
+			}
 
 			auto fragmentShaderCode = CODE(\
 				#version 420 core \n\
-				#extension GL_ARB_gpu_shader_fp64 : enable \n\
 
 				precision highp float;
 
-				layout(location = 0) out uvec4 value;
-				layout(location = 1) out uvec4 iterations;
-				layout(location = 2) out vec4 color;
+				uniform ivec2 grid;
+				uniform int tileSize;
+
+				uniform vec4 parameterViewport;
+				uniform vec4 juliaViewport;
+
+				uniform int maxIterations;
+				uniform float bound;
 
+				out vec4 color;
+			);
+
+			fragmentShaderCode += formula::Expression::getGLSLFunctions(false);
+			fragmentShaderCode += expression->compileGLSL("formula", false, true);
+
+			fragmentShaderCode += CODE(
 				void main()
 				{
-					value = uvec4(0);
-					iterations = uvec4(0);
+					ivec2 pixel = ivec2(gl_FragCoord.xy);
+					ivec2 tile = pixel / tileSize;
+
+					vec2 local = (vec2(pixel - tile * tileSize) + 0.5) / float(tileSize);
+
+					vec2 c = mix(parameterViewport.xz, parameterViewport.yw, (vec2(tile) + 0.5) / vec2(grid));
+					vec2 z = mix(juliaViewport.xz, juliaViewport.yw, local);
+
+					int iterations = 0;
+
+					for (int i = 0; i < maxIterations; i++)
+					{
+						z = formula(z, c);
+
+						iterations++;
+
+						if (dot(z, z) > bound * bound)
+						{
+							break;
+						}
+					}
+
 					color = vec4(0.0, 0.0, 0.0, 1.0);
+
+					if (iterations < maxIterations)
+					{
+						color.r = pow(sin(float(iterations) / 10.0), 2.0);
+					}
 				}
 			);
 
-			this->programClear = gl::compileAndLinkShaders(vertexShaderCode, fragmentShaderCode);
+			this->programAtlas = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
+
+			this->locationGrid = glGetUniformLocation(this->programAtlas, "grid");
+			this->locationTileSize = glGetUniformLocation(this->programAtlas, "tileSize");
+
+			this->locationParameterViewport = glGetUniformLocation(this->programAtlas, "parameterViewport");
+			this->locationJuliaViewport = glGetUniformLocation(this->programAtlas, "juliaViewport");
+
+			this->locationMaxIterations = glGetUniformLocation(this->programAtlas, "maxIterations");
+			this->locationBound = glGetUniformLocation(this->programAtlas, "bound");
+
+			this->expression = expression;
+
+			return true;
+		}
+
+		void renderAtlasGPU()
+		{
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferColor);
+
+			glViewport(0, 0, this->size.x, this->size.y);
+
+			glUseProgram(this->programAtlas);
 
+			glUniform2iv(this->locationGrid, 1, reinterpret_cast<const GLint*>(&this->grid));
+			glUniform1i(this->locationTileSize, this->tileSize);
 
-			fragmentShaderCode = CODE(\
-				#version 420 core \n\
-				#extension GL_ARB_gpu_shader_fp64 : enable \n\
+			glm::vec4 fParameterViewport(this->parameterViewport.viewport);
+			glm::vec4 fJuliaViewport(this->juliaViewport.viewport);
 
-				precision highp float;
+			glUniform4fv(this->locationParameterViewport, 1, reinterpret_cast<const GLfloat*>(&fParameterViewport));
+			glUniform4fv(this->locationJuliaViewport, 1, reinterpret_cast<const GLfloat*>(&fJuliaViewport));
 
-				layout(binding = 0) uniform usampler2D samplerValues;
-				layout(binding = 1) uniform usampler2D samplerIterations;
+			glUniform1i(this->locationMaxIterations, this->maxIterations);
+			glUniform1f(this->locationBound, 2.0f);
 
-				uniform double bound;
-				uniform uint currentIteration;
+			glDrawArrays(GL_TRIANGLES, 0, 6);
 
-				uniform ivec2 size;
-				uniform dvec4 viewport;
+			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		}
 
-				uniform int iterationsPerFrame;
+		void renderAtlasCPU()
+		{
+			auto program = this->expression->compileProgram();
 
-				layout(location = 0) out uvec4 value;
-				layout(location = 1) out uvec4 iterations;
-				layout(location = 2) out vec4 color;
+			std::vector<int> pixels(this->size.x * this->size.y);
 
-				void main()
+			std::int32_t numThreads = glm::max(1, static_cast<std::int32_t>(std::thread::hardware_concurrency()));
+
+			std::vector<std::thread> threads;
+
+			for (std::int32_t t = 0; t < numThreads; t++)
+			{
+				threads.push_back(std::thread([&, t]()
 				{
-					ivec2 pixel = ivec2(gl_FragCoord.xy);
+					std::vector<double> zRe(this->size.x), zIm(this->size.x), cRe(this->size.x), cIm(this->size.x);
+					std::vector<std::uint32_t> iterations(this->size.x);
 
-					uvec4 oldValue = texelFetch(samplerValues, pixel, 0);
+					for (std::int32_t y = t; y < this->size.y; y += numThreads)
+					{
+						std::int32_t tileY = y / this->tileSize;
 
-					dvec2 z = dvec2(packDouble2x32(oldValue.xy), packDouble2x32(oldValue.zw));
+						for (std::int32_t x = 0; x < this->size.x; x++)
+						{
+							std::int32_t tileX = x / this->tileSize;
 
-					iterations = texelFetch(samplerIterations, pixel, 0);
+							glm::dvec2 local = (glm::dvec2(x - tileX * this->tileSize, y - tileY * this->tileSize) + 0.5) / double(this->tileSize);
+							glm::dvec2 parameter = (glm::dvec2(tileX, tileY) + 0.5) / glm::dvec2(this->grid);
 
-					color = vec4(0.0, 0.0, 0.0, 1.0);
+							zRe[x] = glm::mix(this->juliaViewport.left, this->juliaViewport.right, local.x);
+							zIm[x] = glm::mix(this->juliaViewport.bottom, this->juliaViewport.top, local.y);
+							cRe[x] = glm::mix(this->parameterViewport.left, this->parameterViewport.right, parameter.x);
+							cIm[x] = glm::mix(this->parameterViewport.bottom, this->parameterViewport.top, parameter.y);
+						}
 
-					dvec2 c = mix(viewport.xz, viewport.yw, dvec2(gl_FragCoord.xy) / size);
+						program.escape(zRe.data(), zIm.data(), cRe.data(), cIm.data(), this->size.x, this->maxIterations, 2.0, iterations.data());
 
-					if (z.x != 1.0 / 0.0)
-					{
-						for (int i = 0; i < iterationsPerFrame; i++)
+						for (std::int32_t x = 0; x < this->size.x; x++)
 						{
-							z = dvec2(z.x * z.x - z.y * z.y, 2.0 * z.x * z.y) + c;
-
-							iterations.r++;
+							int red = 0;
 
-							if (z.x * z.x + z.y * z.y > bound * bound)
+							if (iterations[x] < static_cast<std::uint32_t>(this->maxIterations))
 							{
-								z.x = 1.0 / 0.0;
-
-								break;
+								red = static_cast<int>(std::pow(std::sin(double(iterations[x]) / 10.0), 2.0) * 255.0 + 0.5);
 							}
-						}
-					}
 
-					if (z.x == 1.0 / 0.0)
-					{
-						color.r = pow(sin(float(iterations.r) / 10.0), 2.0);
-					}
-					else if (currentIteration <= iterations.g)
-					{
-						color.r = pow(sin(float(iterations.g) / 10.0), 2.0);
+							pixels[y * this->size.x + x] = red | (0xFF << 24);
+						}
 					}
+				}));
+			}
 
-					value.xy = unpackDouble2x32(z.x);
-					value.zw = unpackDouble2x32(z.y);
-				}
-			);
+			for (auto& thread : threads)
+			{
+				thread.join();
+			}
 
-			this->programIterate = gl::compileAndLinkShaders(vertexShaderCode, fragmentShaderCode);
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
 
-			this->locationBound = glGetUniformLocation(this->programIterate, "bound");
-			this->locationCurrentIteration = glGetUniformLocation(this->programIterate, "currentIteration");
+			glTexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, this->size.x, this->size.y, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+		}
 
-			this->locationSize = glGetUniformLocation(this->programIterate, "size");
-			this->locationViewport = glGetUniformLocation(this->programIterate, "viewport");
+	public:
+		JuliaAtlas(const glm::ivec2& grid, const std::int32_t tileSize = 64, const Viewport& parameterViewport = Viewport(-2.0, 1.0, -1.5, 1.5)) :
+			grid(grid), tileSize(tileSize), parameterViewport(parameterViewport), juliaViewport(-2.0, 2.0, -2.0, 2.0), viewportRequested(parameterViewport),
+			maxIterations(256), backend(Backend::GPU), formula("z^2 + c"), changed(true)
+		{
+			this->vertexShaderCode = CODE(\
+				#version 420 core \n\
 
-			this->locationIterationsPerFrame = glGetUniformLocation(this->programIterate, "iterationsPerFrame");
+				vec2 vertices[4] = vec2[](vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0), vec2(1.0, 1.0));
+				int indices[6] = int[](0, 1, 2, 1, 2, 3);
 
+				void main()
+				{
+					gl_Position = vec4(vertices[indices[gl_VertexID]] * 2.0 - vec2(1.0), 0.0, 1.0);
+				}
+			);
 
-			fragmentShaderCode = CODE(\
+			auto fragmentShaderCode = CODE(\
 				#version 420 core \n\
 
 				precision highp float;
@@ -1390,193 +5358,188 @@ namespace fractals
 
 				uniform ivec2 resolution;
 
+				uniform vec4 viewport;
+				uniform vec4 viewportRequested;
+
 				out vec4 color;
 
-				void main()
+				vec2 fromScreen(const vec2 screen, const vec4 viewport)
 				{
-					vec2 screen = gl_FragCoord.xy / resolution;
-
-					color = texture(sampler, screen);
+					return viewport.xz + screen * (viewport.yw - viewport.xz);
 				}
-			);
-
-			this->programRender = gl::compileAndLinkShaders(vertexShaderCode, fragmentShaderCode);
-
-			this->locationResolution = glGetUniformLocation(this->programRender, "resolution");
-
-			fragmentShaderCode = CODE(\
-				#version 420 core \n\
-				#extension GL_ARB_gpu_shader_fp64 : enable \n\
-
-				precision highp float;
-				
-				layout(binding = 0) uniform usampler2D samplerValues;
-				layout(binding = 1) uniform usampler2D samplerIterations;
-
-				uniform ivec2 size;
-				uniform ivec2 sizeOld;
-
-				uniform dvec4 viewport;
-				uniform dvec4 viewportOld;
 
-				layout(location = 0) out uvec4 value;
-				layout(location = 1) out uvec4 iterations;
-				layout(location = 2) out vec4 color;
+				vec2 toScreen(const vec2 pos, const vec4 viewport)
+				{
+					return (pos - viewport.xz) / (viewport.yw - viewport.xz);
+				}
 
 				void main()
 				{
-					dvec2 screen = dvec2(gl_FragCoord.xy) / size;
+					vec2 screen = gl_FragCoord.xy / resolution;
 
-					dvec2 pos = mix(viewport.xz, viewport.yw, screen);
+					vec2 pos = toScreen(fromScreen(screen, viewportRequested), viewport);
 
-					dvec2 screenOld = (pos - viewportOld.xz) / (viewportOld.yw - viewportOld.xz);
+					color = texture(sampler, pos);
+				}
+			);
 
-					dvec2 fragCoordOld = screenOld * sizeOld;
+			this->programRender = gl::compileAndLinkShaders(this->vertexShaderCode, fragmentShaderCode);
 
-					ivec2 pixel = ivec2(fragCoordOld);
+			this->locationResolution = glGetUniformLocation(this->programRender, "resolution");
 
-					uvec4 iterationsOld = texelFetch(samplerIterations, pixel, 0);
+			this->locationViewport = glGetUniformLocation(this->programRender, "viewport");
+			this->locationViewportRequested = glGetUniformLocation(this->programRender, "viewportRequested");
 
-					uvec4 oldValue = texelFetch(samplerValues, pixel, 0);
+			this->compileAtlasProgram();
 
-					dvec2 z = dvec2(packDouble2x32(oldValue.xy), packDouble2x32(oldValue.zw));
+			this->setup();
+		}
 
-					value = uvec4(0);
-					iterations = uvec4(0, 0, 0, 0);
-					color = vec4(0.0, 0.0, 0.0, 1.0);
+		virtual void reset() override
+		{
+			this->changed = true;
+		}
 
-					if (z.x == 1.0 / 0.0)
-					{
-						iterations.g = iterationsOld.r;
-					}
-					else if (iterationsOld.r < iterationsOld.g)
-					{
-						iterations.g = iterationsOld.g;
-					}
-				}
-			);
+		virtual void iterate(const std::int32_t iterations) override
+		{
+			if (!this->changed)
+			{
+				return;
+			}
 
-			this->programUpdate = gl::compileAndLinkShaders(vertexShaderCode, fragmentShaderCode);
+			if (this->backend == Backend::CPU)
+			{
+				this->renderAtlasCPU();
+			}
+			else
+			{
+				this->renderAtlasGPU();
+			}
 
-			this->locationSizeUpdate = glGetUniformLocation(this->programUpdate, "size");
-			this->locationSizeOldUpdate = glGetUniformLocation(this->programUpdate, "sizeOld");
+			glBindTexture(GL_TEXTURE_2D, this->textureColor);
 
-			this->locationViewportUpdate = glGetUniformLocation(this->programUpdate, "viewport");
-			this->locationViewportOldUpdate = glGetUniformLocation(this->programUpdate, "viewportOld");
+			glGenerateMipmap(GL_TEXTURE_2D);
 
-			this->initialize(resolution, oversampling);
+			this->changed = false;
 		}
 
-		virtual void reset() override
+		virtual void render(const glm::ivec2& resolution, const Viewport& viewport) override
 		{
-			glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
+			this->viewportRequested = viewport;
 
-			glViewport(0, 0, this->size.x, this->size.y);
+			glViewport(0, 0, resolution.x, resolution.y);
 
-			glUseProgram(this->programClear);
+			glUseProgram(this->programRender);
 
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, this->textureIterations);
+			glUniform2iv(this->locationResolution, 1, reinterpret_cast<const GLint*>(&resolution));
 
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, this->textureValues);
+			glm::vec4 fViewport(this->parameterViewport.viewport);
+			glm::vec4 fViewportRequested(viewport.viewport);
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+			glUniform4fv(this->locationViewport, 1, reinterpret_cast<const GLfloat*>(&fViewport));
+			glUniform4fv(this->locationViewportRequested, 1, reinterpret_cast<const GLfloat*>(&fViewportRequested));
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+			glm::vec4 borderColor(0.0f, 0.0f, 0.0f, 1.0f);
 
 			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+			glTexParameterfv(GL_TEXTURE_2D, GL_TEXTURE_BORDER_COLOR, reinterpret_cast<GLfloat*>(&borderColor));
 
-			glGenerateMipmap(GL_TEXTURE_2D);
-
-			this->currentIteration = 0;
+			glDrawArrays(GL_TRIANGLES, 0, 6);
 		}
 
-		virtual void iterate(const std::int32_t iterations) override
+		virtual Viewport getPreferredViewport() const override
 		{
-			glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
-
-			glViewport(0, 0, this->size.x, this->size.y);
+			return this->parameterViewport;
+		}
 
-			glUseProgram(this->programIterate);
+		virtual void options() override
+		{
+			bool resized = ImGui::InputInt2("Grid", reinterpret_cast<int*>(&this->grid));
 
-			glUniform1d(this->locationBound, 2.0);
-			glUniform1ui(this->locationCurrentIteration, this->currentIteration);
+			resized |= ImGui::SliderInt("Tile Size", &this->tileSize, 16, 256);
 
-			glUniform2iv(this->locationSize, 1, reinterpret_cast<const GLint*>(&this->size));
-			glUniform4dv(this->locationViewport, 1, reinterpret_cast<const GLdouble*>(&this->viewport));
+			if (resized)
+			{
+				this->grid = glm::max(this->grid, glm::ivec2(1));
+				this->tileSize = glm::max(this->tileSize, 1);
 
-			glUniform1i(this->locationIterationsPerFrame, iterations);
+				this->setup();
+			}
 
-			glActiveTexture(GL_TEXTURE1);
-			glBindTexture(GL_TEXTURE_2D, this->textureIterations);
+			Fractal::options();
 
-			glActiveTexture(GL_TEXTURE0);
-			glBindTexture(GL_TEXTURE_2D, this->textureValues);
+			const char* backends[] = { "GPU", "CPU" };
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+			int backend = static_cast<int>(this->backend);
 
-			this->currentIteration += iterations;
+			if (ImGui::Combo("Backend", &backend, backends, sizeof(backends) / sizeof(backends[0])))
+			{
+				this->backend = static_cast<Backend>(backend);
 
-			glBindFramebuffer(GL_FRAMEBUFFER, 0);
+				this->reset();
+			}
 
-			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+			this->changed |= ImGui::SliderInt("Max Iterations", &this->maxIterations, 1, 4096);
 
-			glGenerateMipmap(GL_TEXTURE_2D);
-		}
+			glm::vec4 parameterViewport(this->parameterViewport.viewport);
+			glm::vec4 juliaViewport(this->juliaViewport.viewport);
 
-		virtual void render(const glm::ivec2& resolution, const Viewport& viewport) override
-		{
-			glUseProgram(this->programRender);
+			if (ImGui::InputFloat4("Parameter Viewport", reinterpret_cast<float*>(&parameterViewport)))
+			{
+				this->parameterViewport.viewport = parameterViewport;
 
-			glUniform2iv(this->locationResolution, 1, reinterpret_cast<const GLint*>(&resolution));
+				this->reset();
+			}
 
-			glBindTexture(GL_TEXTURE_2D, this->textureColor);
+			if (ImGui::Button("Sample Current View"))
+			{
+				this->parameterViewport = this->viewportRequested;
 
-			glDrawArrays(GL_TRIANGLES, 0, 6);
+				this->reset();
+			}
 
-			if (resolution != this->resolution || viewport.viewport != this->viewport.viewport)
+			if (ImGui::InputFloat4("Julia Viewport", reinterpret_cast<float*>(&juliaViewport)))
 			{
-				this->update(resolution, viewport, this->oversampling);
+				this->juliaViewport.viewport = juliaViewport;
 
-				glViewport(0, 0, resolution.x, resolution.y);
+				this->reset();
 			}
-		}
-
-		virtual Viewport getPreferredViewport() const override
-		{
-			return Viewport(-2.0f, 1.0f, -1.0f, 1.0f);
-		}
 
-		virtual std::int32_t getPreferredIterationsPerFrame() const override
-		{
-			return 10;
-		}
+			std::vector<char> buffer(glm::max(this->formula.size() + 1llu, 1024llu), '\0');
 
-		virtual void options() override
-		{
-			Fractal::options();
+			std::copy(this->formula.begin(), this->formula.end(), buffer.begin());
 
-			std::int32_t oversampling = this->oversampling;
+			if (ImGui::InputText("Formula", buffer.data(), buffer.size()))
+			{
+				this->formula = buffer.data();
 
-			ImGui::SliderInt("Oversampling", &oversampling, 1, 16);
+				try
+				{
+					if (this->compileAtlasProgram())
+					{
+						this->reset();
+					}
+				}
+				catch (const std::exception& exception)
+				{
+					this->formulaError = exception.what();
+				}
+			}
 
-			if (this->oversampling != oversampling)
+			if (!this->formulaError.empty())
 			{
-				this->update(this->resolution, this->viewport, oversampling);
+				ImGui::TextColored(ImVec4(1.0f, 0.33f, 0.33f, 1.0f), "%s", this->formulaError.c_str());
 			}
 		}
 
 		virtual img::ImagePtr exportImage() const override
 		{
-			glBindFramebuffer(GL_FRAMEBUFFER, this->framebuffer);
-			glReadBuffer(GL_COLOR_ATTACHMENT2);
+			glBindFramebuffer(GL_FRAMEBUFFER, this->framebufferColor);
 
 			img::ImagePtr image = img::make(this->size.x, this->size.y);
 
 			glReadPixels(0, 0, this->size.x, this->size.y, GL_RGBA, GL_UNSIGNED_BYTE, image->pixels.data());
 
-			glReadBuffer(GL_COLOR_ATTACHMENT0);
 			glBindFramebuffer(GL_FRAMEBUFFER, 0);
 
 			return image;
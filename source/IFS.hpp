@@ -0,0 +1,2211 @@
+#pragma once
+
+#include "Includes.hpp"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace ifs
+{
+	inline std::int32_t countTrailingZeros(const std::uint64_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+
+		_BitScanForward64(&index, value);
+
+		return static_cast<std::int32_t>(index);
+#else
+		return __builtin_ctzll(value);
+#endif
+	}
+
+	inline std::int32_t countBits(const std::uint64_t value)
+	{
+#ifdef _MSC_VER
+		return static_cast<std::int32_t>(__popcnt64(value));
+#else
+		return __builtin_popcountll(value);
+#endif
+	}
+
+	struct Map
+	{
+		Map(const glm::mat2x2& matrix = glm::mat2x2(1.0f), const glm::vec2& offset = glm::vec2(0.0f), const float p = 0.0f) :
+			a(matrix[0].x), b(matrix[1].x), c(matrix[0].y), d(matrix[1].y), e(offset.x), f(offset.y), p(p)
+		{
+
+		}
+
+		float a, b, c, d, e, f;
+		float p;
+
+		float getDeterminant() const
+		{
+			return this->a * this->d - this->b * this->c;
+		}
+
+		glm::vec2 apply(const glm::vec2& v) const
+		{
+			return glm::vec2(this->a * v.x + this->b * v.y + this->e, this->c * v.x + this->d * v.y + this->f);
+		}
+
+		Map compose(const Map& inner) const
+		{
+			Map map;
+
+			map.a = this->a * inner.a + this->b * inner.c;
+			map.b = this->a * inner.b + this->b * inner.d;
+			map.c = this->c * inner.a + this->d * inner.c;
+			map.d = this->c * inner.b + this->d * inner.d;
+			map.e = this->a * inner.e + this->b * inner.f + this->e;
+			map.f = this->c * inner.e + this->d * inner.f + this->f;
+			map.p = this->p * inner.p;
+
+			return map;
+		}
+
+		Map getInverse() const
+		{
+			float determinant = this->getDeterminant();
+
+			Map inverse;
+
+			inverse.a = this->d / determinant;
+			inverse.b = -this->b / determinant;
+			inverse.c = -this->c / determinant;
+			inverse.d = this->a / determinant;
+			inverse.e = -(inverse.a * this->e + inverse.b * this->f);
+			inverse.f = -(inverse.c * this->e + inverse.d * this->f);
+			inverse.p = this->p;
+
+			return inverse;
+		}
+	};
+
+	enum class Variation : int
+	{
+		Linear = 0,
+		Sinusoidal = 1,
+		Spherical = 2,
+		Swirl = 3,
+		Horseshoe = 4,
+		Polar = 5,
+		Count = 6,
+	};
+
+	constexpr std::int32_t numVariations = static_cast<std::int32_t>(Variation::Count);
+
+	inline const char* getVariationName(const Variation variation)
+	{
+		const char* names[numVariations] = { "Linear", "Sinusoidal", "Spherical", "Swirl", "Horseshoe", "Polar" };
+
+		return names[static_cast<std::int32_t>(variation)];
+	}
+
+	struct Variations
+	{
+		Variations()
+		{
+			this->weights.fill(0.0f);
+
+			this->weights[static_cast<std::int32_t>(Variation::Linear)] = 1.0f;
+		}
+
+		std::array<float, numVariations> weights;
+
+		std::uint32_t getMask() const
+		{
+			std::uint32_t mask = 0;
+
+			for (std::int32_t v = 0; v < numVariations; v++)
+			{
+				mask |= (this->weights[v] != 0.0f ? 1u : 0u) << v;
+			}
+
+			return mask;
+		}
+
+		bool isAffine() const
+		{
+			return this->getMask() == (1u << static_cast<std::int32_t>(Variation::Linear)) && this->weights[static_cast<std::int32_t>(Variation::Linear)] == 1.0f;
+		}
+	};
+
+	inline std::uint32_t getVariationMask(const std::vector<Variations>& variations)
+	{
+		std::uint32_t mask = 0;
+		bool affine = true;
+
+		for (const auto& variation : variations)
+		{
+			mask |= variation.getMask();
+			affine &= variation.isAffine();
+		}
+
+		return affine ? 0u : glm::max(mask, 1u << static_cast<std::int32_t>(Variation::Linear));
+	}
+
+	template <Variation V>
+	struct VariationFunctor;
+
+	template <>
+	struct VariationFunctor<Variation::Linear>
+	{
+		static glm::vec2 apply(const glm::vec2& p)
+		{
+			return p;
+		}
+
+		static const char* getGLSL()
+		{
+			return "p";
+		}
+	};
+
+	template <>
+	struct VariationFunctor<Variation::Sinusoidal>
+	{
+		static glm::vec2 apply(const glm::vec2& p)
+		{
+			return glm::vec2(std::sin(p.x), std::sin(p.y));
+		}
+
+		static const char* getGLSL()
+		{
+			return "sin(p)";
+		}
+	};
+
+	template <>
+	struct VariationFunctor<Variation::Spherical>
+	{
+		static glm::vec2 apply(const glm::vec2& p)
+		{
+			return p * (1.0f / (p.x * p.x + p.y * p.y + 1e-10f));
+		}
+
+		static const char* getGLSL()
+		{
+			return "p / (dot(p, p) + 1e-10)";
+		}
+	};
+
+	template <>
+	struct VariationFunctor<Variation::Swirl>
+	{
+		static glm::vec2 apply(const glm::vec2& p)
+		{
+			float r2 = p.x * p.x + p.y * p.y;
+
+			float s = std::sin(r2);
+			float c = std::cos(r2);
+
+			return glm::vec2(p.x * s - p.y * c, p.x * c + p.y * s);
+		}
+
+		static const char* getGLSL()
+		{
+			return "vec2(p.x * sin(dot(p, p)) - p.y * cos(dot(p, p)), p.x * cos(dot(p, p)) + p.y * sin(dot(p, p)))";
+		}
+	};
+
+	template <>
+	struct VariationFunctor<Variation::Horseshoe>
+	{
+		static glm::vec2 apply(const glm::vec2& p)
+		{
+			float r = std::sqrt(p.x * p.x + p.y * p.y) + 1e-10f;
+
+			return glm::vec2((p.x - p.y) * (p.x + p.y), 2.0f * p.x * p.y) * (1.0f / r);
+		}
+
+		static const char* getGLSL()
+		{
+			return "vec2((p.x - p.y) * (p.x + p.y), 2.0 * p.x * p.y) / (length(p) + 1e-10)";
+		}
+	};
+
+	template <>
+	struct VariationFunctor<Variation::Polar>
+	{
+		static glm::vec2 apply(const glm::vec2& p)
+		{
+			return glm::vec2(std::atan2(p.x, p.y) * 0.318309886f, std::sqrt(p.x * p.x + p.y * p.y) - 1.0f);
+		}
+
+		static const char* getGLSL()
+		{
+			return "vec2(atan(p.x, p.y) * 0.318309886, length(p) - 1.0)";
+		}
+	};
+
+	template <bool Active, std::int32_t V>
+	struct VariationTerm
+	{
+		static void apply(const glm::vec2& p, const float* weights, glm::vec2& result)
+		{
+
+		}
+	};
+
+	template <std::int32_t V>
+	struct VariationTerm<true, V>
+	{
+		static void apply(const glm::vec2& p, const float* weights, glm::vec2& result)
+		{
+			result += weights[V] * VariationFunctor<static_cast<Variation>(V)>::apply(p);
+		}
+	};
+
+	template <std::uint32_t Mask, std::int32_t V = 0>
+	struct VariationMix
+	{
+		static void apply(const glm::vec2& p, const float* weights, glm::vec2& result)
+		{
+			VariationTerm<((Mask >> V) & 1u) != 0, V>::apply(p, weights, result);
+
+			VariationMix<Mask, V + 1>::apply(p, weights, result);
+		}
+	};
+
+	template <std::uint32_t Mask>
+	struct VariationMix<Mask, numVariations>
+	{
+		static void apply(const glm::vec2& p, const float* weights, glm::vec2& result)
+		{
+
+		}
+	};
+
+	template <std::int32_t V = 0>
+	struct VariationGLSL
+	{
+		static void append(const std::uint32_t mask, std::string& code)
+		{
+			if ((mask >> V) & 1u)
+			{
+				code += "result += texelFetch(weights, " + std::to_string((numVariations + 3) / 4) + " * k + " + std::to_string(V / 4) + ")." + "xyzw"[V % 4] + " * (" + VariationFunctor<static_cast<Variation>(V)>::getGLSL() + ");\n";
+			}
+
+			VariationGLSL<V + 1>::append(mask, code);
+		}
+	};
+
+	template <>
+	struct VariationGLSL<numVariations>
+	{
+		static void append(const std::uint32_t mask, std::string& code)
+		{
+
+		}
+	};
+
+	inline std::string getVariationGLSLFunction(const std::uint32_t mask)
+	{
+		if (mask == 0)
+		{
+			return "vec2 vary(const vec2 p, const int k)\n{\nreturn p;\n}\n";
+		}
+
+		std::string code = "layout(binding = 2) uniform samplerBuffer weights;\n";
+
+		code += "vec2 vary(const vec2 p, const int k)\n{\nvec2 result = vec2(0.0);\n";
+
+		VariationGLSL<>::append(mask, code);
+
+		code += "return result;\n}\n";
+
+		return code;
+	}
+
+	class Random
+	{
+	private:
+		std::uint64_t state;
+
+	public:
+		Random(const std::uint64_t seed = 0)
+		{
+			this->reset(seed);
+		}
+
+		void reset(const std::uint64_t seed)
+		{
+			this->state = seed;
+
+			for (std::int32_t i = 0; i < 4; i++)
+			{
+				this->next();
+			}
+		}
+
+		std::uint64_t next()
+		{
+			std::uint64_t z = (this->state += 0x9E3779B97F4A7C15ull);
+
+			z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+			z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+
+			return z ^ (z >> 31);
+		}
+
+		float nextFloat()
+		{
+			return static_cast<float>(this->next() >> 40) * (1.0f / 16777216.0f);
+		}
+	};
+
+	class AliasTable
+	{
+	private:
+		std::vector<float> probabilities;
+		std::vector<std::uint32_t> thresholds;
+		std::vector<std::uint32_t> aliases;
+
+	public:
+		AliasTable(const std::vector<float>& weights = { })
+		{
+			std::size_t n = weights.size();
+
+			this->probabilities.resize(n, 1.0f);
+			this->thresholds.resize(n, 0xFFFFFFFFu);
+			this->aliases.resize(n);
+
+			double total = 0.0;
+
+			for (const auto& weight : weights)
+			{
+				total += glm::max(weight, 0.0f);
+			}
+
+			std::vector<double> scaled(n);
+
+			std::vector<std::uint32_t> small;
+			std::vector<std::uint32_t> large;
+
+			for (std::size_t i = 0; i < n; i++)
+			{
+				this->aliases[i] = static_cast<std::uint32_t>(i);
+
+				scaled[i] = total > 0.0 ? glm::max(weights[i], 0.0f) * double(n) / total : 1.0;
+
+				(scaled[i] < 1.0 ? small : large).push_back(static_cast<std::uint32_t>(i));
+			}
+
+			while (!small.empty() && !large.empty())
+			{
+				std::uint32_t l = small.back();
+				std::uint32_t g = large.back();
+
+				small.pop_back();
+				large.pop_back();
+
+				this->probabilities[l] = static_cast<float>(scaled[l]);
+				this->thresholds[l] = static_cast<std::uint32_t>(glm::min(scaled[l] * 4294967296.0, 4294967295.0));
+				this->aliases[l] = g;
+
+				scaled[g] = (scaled[g] + scaled[l]) - 1.0;
+
+				(scaled[g] < 1.0 ? small : large).push_back(g);
+			}
+		}
+
+		std::size_t size() const
+		{
+			return this->aliases.size();
+		}
+
+		float getProbability(const std::size_t i) const
+		{
+			return this->probabilities[i];
+		}
+
+		std::uint32_t getAlias(const std::size_t i) const
+		{
+			return this->aliases[i];
+		}
+
+		std::uint32_t sample(const std::uint64_t random) const
+		{
+			std::uint32_t column = static_cast<std::uint32_t>(((random >> 32) * this->aliases.size()) >> 32);
+
+			return static_cast<std::uint32_t>(random) < this->thresholds[column] ? column : this->aliases[column];
+		}
+	};
+
+	inline float getContraction(const std::vector<Map>& maps)
+	{
+		float contraction = 0.0f;
+
+		for (const auto& map : maps)
+		{
+			float t = map.a * map.a + map.b * map.b + map.c * map.c + map.d * map.d;
+			float determinant = map.getDeterminant();
+
+			contraction = glm::max(contraction, std::sqrt((t + std::sqrt(glm::max(0.0f, t * t - 4.0f * determinant * determinant))) / 2.0f));
+		}
+
+		return contraction;
+	}
+
+	inline std::vector<float> getWeights(const std::vector<Map>& maps)
+	{
+		bool probabilistic = false;
+
+		for (const auto& map : maps)
+		{
+			probabilistic |= map.p > 0.0f;
+		}
+
+		std::vector<float> weights;
+
+		for (const auto& map : maps)
+		{
+			weights.push_back(probabilistic ? map.p : glm::max(glm::abs(map.getDeterminant()), 0.01f));
+		}
+
+		return weights;
+	}
+
+	inline std::vector<Map> getCompositions(const std::vector<Map>& maps, const std::int32_t depth)
+	{
+		std::vector<Map> compositions = maps;
+
+		for (std::int32_t i = 1; i < depth; i++)
+		{
+			std::vector<Map> next;
+
+			for (const auto& outer : maps)
+			{
+				for (const auto& inner : compositions)
+				{
+					next.push_back(outer.compose(inner));
+				}
+			}
+
+			compositions = next;
+		}
+
+		return compositions;
+	}
+
+	inline std::int32_t getFusionDepth(const std::size_t numMaps, const std::uint64_t active, const std::uint64_t pixels, const std::size_t maxMaps = 64, const std::int32_t maxDepth = 8)
+	{
+		std::int32_t depth = 1;
+
+		std::uint64_t fused = numMaps;
+
+		while (numMaps > 0 && depth < maxDepth && fused * numMaps <= maxMaps && active * fused * numMaps <= pixels)
+		{
+			fused *= numMaps;
+
+			depth++;
+		}
+
+		return depth;
+	}
+
+	inline bool isGatherable(const std::vector<Map>& maps, const glm::ivec2& size, const glm::dvec4& bounds, const float maxExtent = 32.0f)
+	{
+		float pixelX = static_cast<float>((bounds.y - bounds.x) / size.x);
+		float pixelY = static_cast<float>((bounds.w - bounds.z) / size.y);
+
+		for (const auto& map : maps)
+		{
+			if (glm::abs(map.getDeterminant()) < 1e-6f)
+			{
+				return false;
+			}
+
+			Map inverse = map.getInverse();
+
+			float extentX = (glm::abs(inverse.a) * pixelX + glm::abs(inverse.b) * pixelY) / pixelX;
+			float extentY = (glm::abs(inverse.c) * pixelX + glm::abs(inverse.d) * pixelY) / pixelY;
+
+			if (glm::max(extentX, extentY) > maxExtent)
+			{
+				return false;
+			}
+		}
+
+		return maps.size() > 0;
+	}
+
+	inline glm::dmat2 getMatrix(const Map& map)
+	{
+		return glm::dmat2(glm::dvec2(map.a, map.c), glm::dvec2(map.b, map.d));
+	}
+
+	inline double getNorm(const glm::dmat2& matrix)
+	{
+		double t = matrix[0].x * matrix[0].x + matrix[0].y * matrix[0].y + matrix[1].x * matrix[1].x + matrix[1].y * matrix[1].y;
+		double determinant = glm::determinant(matrix);
+
+		return std::sqrt((t + std::sqrt(glm::max(0.0, t * t - 4.0 * determinant * determinant))) / 2.0);
+	}
+
+	inline bool getBoundingBall(const std::vector<Map>& maps, glm::dvec2& center, double& radius)
+	{
+		center = glm::dvec2(0.0);
+		radius = 0.0;
+
+		std::size_t numFixpoints = 0;
+
+		for (const auto& map : maps)
+		{
+			glm::dmat2 matrix(glm::dvec2(1.0 - map.a, -double(map.c)), glm::dvec2(-double(map.b), 1.0 - map.d));
+
+			if (glm::abs(glm::determinant(matrix)) > 1e-9)
+			{
+				center += glm::inverse(matrix) * glm::dvec2(map.e, map.f);
+
+				numFixpoints++;
+			}
+		}
+
+		if (numFixpoints > 0)
+		{
+			center /= double(numFixpoints);
+		}
+
+		for (const auto& map : maps)
+		{
+			double contraction = getNorm(getMatrix(map));
+
+			if (contraction >= 1.0)
+			{
+				return false;
+			}
+
+			double distance = glm::length(getMatrix(map) * center + glm::dvec2(map.e, map.f) - center);
+
+			radius = glm::max(radius, distance / (1.0 - contraction));
+		}
+
+		return maps.size() > 0;
+	}
+
+	inline bool getBoundingBox(const std::vector<Map>& maps, glm::dvec4& bounds, const std::size_t numSamples = std::size_t(1) << 16, const std::uint64_t seed = 0)
+	{
+		glm::dvec2 center;
+		double radius;
+
+		if (!getBoundingBall(maps, center, radius))
+		{
+			return false;
+		}
+
+		glm::dvec2 lower = center - glm::dvec2(radius);
+		glm::dvec2 upper = center + glm::dvec2(radius);
+
+		for (std::int32_t i = 0; i < 64; i++)
+		{
+			glm::dvec2 middle = (lower + upper) * 0.5;
+			glm::dvec2 half = (upper - lower) * 0.5;
+
+			glm::dvec2 nextLower(std::numeric_limits<double>::infinity());
+			glm::dvec2 nextUpper(-std::numeric_limits<double>::infinity());
+
+			for (const auto& map : maps)
+			{
+				glm::dvec2 image = getMatrix(map) * middle + glm::dvec2(map.e, map.f);
+				glm::dvec2 extent(glm::abs(map.a) * half.x + glm::abs(map.b) * half.y, glm::abs(map.c) * half.x + glm::abs(map.d) * half.y);
+
+				nextLower = glm::min(nextLower, image - extent);
+				nextUpper = glm::max(nextUpper, image + extent);
+			}
+
+			lower = glm::max(lower, nextLower);
+			upper = glm::min(upper, nextUpper);
+		}
+
+		AliasTable aliasTable(getWeights(maps));
+
+		Random random(seed);
+
+		glm::dvec2 point = center;
+
+		glm::dvec2 sampleLower(std::numeric_limits<double>::infinity());
+		glm::dvec2 sampleUpper(-std::numeric_limits<double>::infinity());
+
+		for (std::size_t i = 0; i < numSamples + 64; i++)
+		{
+			const Map& map = maps[aliasTable.sample(random.next())];
+
+			point = getMatrix(map) * point + glm::dvec2(map.e, map.f);
+
+			if (i >= 64)
+			{
+				sampleLower = glm::min(sampleLower, point);
+				sampleUpper = glm::max(sampleUpper, point);
+			}
+		}
+
+		double margin = 0.02 * glm::max(glm::max(sampleUpper.x - sampleLower.x, sampleUpper.y - sampleLower.y), 1e-6);
+
+		lower = glm::max(lower, sampleLower - glm::dvec2(margin));
+		upper = glm::min(upper, sampleUpper + glm::dvec2(margin));
+
+		bounds = glm::dvec4(lower.x, upper.x, lower.y, upper.y);
+
+		return true;
+	}
+
+	inline void parallel(const std::int32_t numThreads, const std::function<void(const std::int32_t)>& function)
+	{
+		std::vector<std::thread> threads;
+
+		for (std::int32_t t = 1; t < numThreads; t++)
+		{
+			threads.push_back(std::thread(function, t));
+		}
+
+		function(0);
+
+		for (auto& thread : threads)
+		{
+			thread.join();
+		}
+	}
+
+	class ChaosGame
+	{
+	public:
+		static constexpr std::size_t batchSize = 1024;
+		static constexpr std::size_t pendingSize = 1 << 16;
+		static constexpr std::int32_t warmup = 64;
+		static constexpr std::int32_t numBands = 64;
+
+	private:
+		struct Worker
+		{
+			Random random;
+
+			alignas(64) float x[batchSize];
+			alignas(64) float y[batchSize];
+			alignas(64) float color[batchSize];
+			alignas(64) std::uint32_t choice[batchSize];
+			alignas(64) std::uint32_t index[batchSize];
+
+			std::vector<std::uint32_t> raster;
+			std::vector<double> colorRaster;
+			std::vector<std::uint32_t> pending;
+			std::vector<std::uint32_t> sorted;
+			std::vector<float> pendingColors;
+			std::vector<float> sortedColors;
+			std::size_t numPending = 0;
+		};
+
+		typedef void (ChaosGame::*VariationFunction)(Worker&) const;
+
+		std::vector<Map> maps;
+		AliasTable aliasTable;
+
+		std::vector<float> a, b, c, d, e, f;
+
+		std::vector<Variations> variations;
+		std::vector<float> weights;
+		std::uint32_t variationMask;
+		VariationFunction applyVariations;
+
+		glm::ivec2 size;
+		glm::dvec4 bounds;
+
+		std::int32_t numThreads;
+		std::size_t memoryBudget;
+		bool privateRasters;
+		bool colored;
+
+		std::uint64_t seed;
+		std::uint64_t numPoints;
+
+		std::vector<std::unique_ptr<Worker>> workers;
+
+		std::vector<std::uint64_t> hits;
+		std::vector<double> colors;
+		std::vector<float> mapColors;
+		std::vector<std::mutex> bandMutexes;
+
+		void prepare()
+		{
+			this->aliasTable = AliasTable(getWeights(this->maps));
+
+			this->a.clear(); this->b.clear(); this->c.clear();
+			this->d.clear(); this->e.clear(); this->f.clear();
+
+			for (const auto& map : this->maps)
+			{
+				this->a.push_back(map.a);
+				this->b.push_back(map.b);
+				this->c.push_back(map.c);
+				this->d.push_back(map.d);
+				this->e.push_back(map.e);
+				this->f.push_back(map.f);
+			}
+
+			this->mapColors.clear();
+
+			for (std::size_t k = 0; k < this->maps.size(); k++)
+			{
+				this->mapColors.push_back(this->maps.size() > 1 ? float(k) / float(this->maps.size() - 1) : 0.5f);
+			}
+
+			this->variations.resize(this->maps.size());
+
+			this->weights.clear();
+
+			for (const auto& variation : this->variations)
+			{
+				this->weights.insert(this->weights.end(), variation.weights.begin(), variation.weights.end());
+			}
+
+			static const auto functions = getVariationFunctions(std::make_index_sequence<std::size_t(1) << numVariations>());
+
+			this->variationMask = ifs::getVariationMask(this->variations);
+			this->applyVariations = functions[this->variationMask];
+		}
+
+		template <std::size_t... Masks>
+		static std::array<VariationFunction, sizeof...(Masks)> getVariationFunctions(std::index_sequence<Masks...>)
+		{
+			return {{ &ChaosGame::applyVariationMix<static_cast<std::uint32_t>(Masks)>... }};
+		}
+
+		template <std::uint32_t Mask>
+		void applyVariationMix(Worker& worker) const
+		{
+			const float* weights = this->weights.data();
+
+			for (std::size_t i = 0; i < batchSize; i++)
+			{
+				std::uint32_t k = worker.choice[i];
+
+				float x = worker.x[i];
+				float y = worker.y[i];
+
+				glm::vec2 p(this->a[k] * x + this->b[k] * y + this->e[k], this->c[k] * x + this->d[k] * y + this->f[k]);
+
+				glm::vec2 result(0.0f);
+
+				VariationMix<Mask>::apply(p, weights + k * numVariations, result);
+
+				if (!std::isfinite(result.x) || !std::isfinite(result.y))
+				{
+					result = glm::vec2(worker.random.nextFloat(), worker.random.nextFloat());
+				}
+
+				worker.x[i] = result.x;
+				worker.y[i] = result.y;
+			}
+		}
+
+		void step(Worker& worker) const
+		{
+			for (std::size_t i = 0; i < batchSize; i++)
+			{
+				worker.choice[i] = this->aliasTable.sample(worker.random.next());
+			}
+
+			if (this->variationMask != 0)
+			{
+				(this->*this->applyVariations)(worker);
+			}
+			else
+			{
+				const float* a = this->a.data();
+				const float* b = this->b.data();
+				const float* c = this->c.data();
+				const float* d = this->d.data();
+				const float* e = this->e.data();
+				const float* f = this->f.data();
+
+				for (std::size_t i = 0; i < batchSize; i++)
+				{
+					std::uint32_t k = worker.choice[i];
+
+					float x = worker.x[i];
+					float y = worker.y[i];
+
+					worker.x[i] = a[k] * x + b[k] * y + e[k];
+					worker.y[i] = c[k] * x + d[k] * y + f[k];
+				}
+			}
+
+			if (this->colored)
+			{
+				const float* mapColors = this->mapColors.data();
+
+				for (std::size_t i = 0; i < batchSize; i++)
+				{
+					worker.color[i] = 0.5f * (worker.color[i] + mapColors[worker.choice[i]]);
+				}
+			}
+		}
+
+		void rasterize(Worker& worker) const
+		{
+			float left = static_cast<float>(this->bounds.x);
+			float bottom = static_cast<float>(this->bounds.z);
+
+			float scaleX = static_cast<float>(this->size.x / (this->bounds.y - this->bounds.x));
+			float scaleY = static_cast<float>(this->size.y / (this->bounds.w - this->bounds.z));
+
+			for (std::size_t i = 0; i < batchSize; i++)
+			{
+				float px = (worker.x[i] - left) * scaleX;
+				float py = (worker.y[i] - bottom) * scaleY;
+
+				bool inside = px >= 0.0f && py >= 0.0f && px < float(this->size.x) && py < float(this->size.y);
+
+				worker.index[i] = inside ? static_cast<std::uint32_t>(py) * static_cast<std::uint32_t>(this->size.x) + static_cast<std::uint32_t>(px) : 0xFFFFFFFFu;
+			}
+		}
+
+		void flush(Worker& worker)
+		{
+			if (worker.numPending == 0)
+			{
+				return;
+			}
+
+			std::size_t numPixels = this->hits.size();
+
+			std::size_t bandSize = (numPixels + numBands - 1) / numBands;
+
+			std::size_t offsets[numBands + 1] = { };
+
+			for (std::size_t i = 0; i < worker.numPending; i++)
+			{
+				offsets[worker.pending[i] / bandSize + 1]++;
+			}
+
+			for (std::int32_t band = 0; band < numBands; band++)
+			{
+				offsets[band + 1] += offsets[band];
+			}
+
+			std::size_t cursors[numBands];
+
+			std::copy(offsets, offsets + numBands, cursors);
+
+			for (std::size_t i = 0; i < worker.numPending; i++)
+			{
+				std::size_t j = cursors[worker.pending[i] / bandSize]++;
+
+				worker.sorted[j] = worker.pending[i];
+
+				if (this->colored)
+				{
+					worker.sortedColors[j] = worker.pendingColors[i];
+				}
+			}
+
+			for (std::int32_t band = 0; band < numBands; band++)
+			{
+				if (offsets[band] == offsets[band + 1])
+				{
+					continue;
+				}
+
+				std::lock_guard<std::mutex> lock(this->bandMutexes[band]);
+
+				for (std::size_t i = offsets[band]; i < offsets[band + 1]; i++)
+				{
+					this->hits[worker.sorted[i]]++;
+				}
+
+				if (this->colored)
+				{
+					for (std::size_t i = offsets[band]; i < offsets[band + 1]; i++)
+					{
+						this->colors[worker.sorted[i]] += worker.sortedColors[i];
+					}
+				}
+			}
+
+			worker.numPending = 0;
+		}
+
+		void work(Worker& worker, const std::uint64_t points)
+		{
+			for (std::uint64_t done = 0; done < points; done += batchSize)
+			{
+				this->step(worker);
+
+				this->rasterize(worker);
+
+				if (this->privateRasters)
+				{
+					std::uint32_t* raster = worker.raster.data();
+
+					for (std::size_t i = 0; i < batchSize; i++)
+					{
+						if (worker.index[i] != 0xFFFFFFFFu)
+						{
+							raster[worker.index[i]]++;
+						}
+					}
+
+					if (this->colored)
+					{
+						double* colorRaster = worker.colorRaster.data();
+
+						for (std::size_t i = 0; i < batchSize; i++)
+						{
+							if (worker.index[i] != 0xFFFFFFFFu)
+							{
+								colorRaster[worker.index[i]] += worker.color[i];
+							}
+						}
+					}
+				}
+				else
+				{
+					for (std::size_t i = 0; i < batchSize; i++)
+					{
+						if (worker.index[i] != 0xFFFFFFFFu)
+						{
+							if (this->colored)
+							{
+								worker.pendingColors[worker.numPending] = worker.color[i];
+							}
+
+							worker.pending[worker.numPending++] = worker.index[i];
+						}
+					}
+
+					if (worker.numPending + batchSize > pendingSize)
+					{
+						this->flush(worker);
+					}
+				}
+			}
+
+			if (!this->privateRasters)
+			{
+				this->flush(worker);
+			}
+		}
+
+		void merge()
+		{
+			std::size_t numPixels = this->hits.size();
+
+			std::size_t chunk = (numPixels + this->numThreads - 1) / this->numThreads;
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				std::size_t begin = glm::min(numPixels, t * chunk);
+				std::size_t end = glm::min(numPixels, begin + chunk);
+
+				for (const auto& worker : this->workers)
+				{
+					std::uint32_t* raster = worker->raster.data();
+
+					for (std::size_t i = begin; i < end; i++)
+					{
+						this->hits[i] += raster[i];
+					}
+
+					std::fill(raster + begin, raster + end, 0u);
+
+					if (this->colored)
+					{
+						double* colorRaster = worker->colorRaster.data();
+
+						for (std::size_t i = begin; i < end; i++)
+						{
+							this->colors[i] += colorRaster[i];
+						}
+
+						std::fill(colorRaster + begin, colorRaster + end, 0.0);
+					}
+				}
+			});
+		}
+
+	public:
+		ChaosGame(const std::vector<Map>& maps, const glm::ivec2& size, const glm::dvec4& bounds, const std::int32_t numThreads = 0, const std::size_t memoryBudget = std::size_t(1) << 30, const std::uint64_t seed = 0, const bool colored = false, const std::vector<Variations>& variations = { }) :
+			maps(maps), variations(variations), size(size), bounds(bounds), memoryBudget(memoryBudget), colored(colored), seed(seed), numPoints(0), bandMutexes(numBands)
+		{
+			if (this->maps.size() == 0)
+			{
+				throw std::runtime_error("IFS-Error: No maps given.");
+			}
+
+			if (std::uint64_t(std::uint32_t(size.x)) * std::uint64_t(std::uint32_t(size.y)) > 0xFFFFFFFFull)
+			{
+				throw std::runtime_error("IFS-Error: Chaos game rasters are limited to 2^32 - 1 pixels.");
+			}
+
+			this->numThreads = numThreads > 0 ? numThreads : glm::max(1, static_cast<std::int32_t>(std::thread::hardware_concurrency()));
+
+			std::size_t rasterBytes = std::size_t(size.x) * std::size_t(size.y) * (sizeof(std::uint32_t) + (colored ? sizeof(double) : 0));
+
+			this->privateRasters = rasterBytes * std::size_t(this->numThreads) <= this->memoryBudget;
+
+			this->hits.resize(std::size_t(size.x) * std::size_t(size.y), 0u);
+
+			if (colored)
+			{
+				this->colors.resize(this->hits.size(), 0.0);
+			}
+
+			this->prepare();
+
+			for (std::int32_t t = 0; t < this->numThreads; t++)
+			{
+				auto worker = std::make_unique<Worker>();
+
+				if (this->privateRasters)
+				{
+					worker->raster.resize(this->hits.size(), 0u);
+					worker->colorRaster.resize(this->colors.size(), 0.0);
+				}
+				else
+				{
+					worker->pending.resize(pendingSize);
+					worker->sorted.resize(pendingSize);
+
+					if (colored)
+					{
+						worker->pendingColors.resize(pendingSize);
+						worker->sortedColors.resize(pendingSize);
+					}
+				}
+
+				this->workers.push_back(std::move(worker));
+			}
+
+			this->reset(seed);
+		}
+
+		void setMaps(const std::vector<Map>& maps, const glm::dvec4& bounds, const std::vector<Variations>& variations = { })
+		{
+			if (maps.size() == 0)
+			{
+				throw std::runtime_error("IFS-Error: No maps given.");
+			}
+
+			this->maps = maps;
+			this->variations = variations;
+			this->bounds = bounds;
+
+			this->prepare();
+
+			this->reset(this->seed);
+		}
+
+		void reset(const std::uint64_t seed)
+		{
+			this->seed = seed;
+			this->numPoints = 0;
+
+			std::fill(this->hits.begin(), this->hits.end(), 0u);
+			std::fill(this->colors.begin(), this->colors.end(), 0.0);
+
+			for (std::size_t t = 0; t < this->workers.size(); t++)
+			{
+				Worker& worker = *this->workers[t];
+
+				worker.random.reset(seed * 0x9E3779B97F4A7C15ull + t + 1);
+
+				for (std::size_t i = 0; i < batchSize; i++)
+				{
+					worker.x[i] = worker.random.nextFloat();
+					worker.y[i] = worker.random.nextFloat();
+					worker.color[i] = worker.random.nextFloat();
+				}
+
+				for (std::int32_t i = 0; i < warmup; i++)
+				{
+					this->step(worker);
+				}
+
+				std::fill(worker.raster.begin(), worker.raster.end(), 0u);
+				std::fill(worker.colorRaster.begin(), worker.colorRaster.end(), 0.0);
+
+				worker.numPending = 0;
+			}
+		}
+
+		void run(const std::uint64_t points)
+		{
+			std::uint64_t perThread = (points + this->numThreads - 1) / this->numThreads;
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				this->work(*this->workers[t], perThread);
+			});
+
+			if (this->privateRasters)
+			{
+				this->merge();
+			}
+
+			this->numPoints += ((perThread + batchSize - 1) / batchSize) * batchSize * this->numThreads;
+		}
+
+		const std::vector<std::uint64_t>& getHits() const
+		{
+			return this->hits;
+		}
+
+		const std::vector<double>& getColors() const
+		{
+			return this->colors;
+		}
+
+		bool isColored() const
+		{
+			return this->colored;
+		}
+
+		std::uint32_t getVariationMask() const
+		{
+			return this->variationMask;
+		}
+
+		const glm::ivec2& getSize() const
+		{
+			return this->size;
+		}
+
+		std::uint64_t getNumPoints() const
+		{
+			return this->numPoints;
+		}
+
+		std::int32_t getNumThreads() const
+		{
+			return this->numThreads;
+		}
+
+		bool hasPrivateRasters() const
+		{
+			return this->privateRasters;
+		}
+	};
+
+	enum class Iteration : int
+	{
+		Scatter = 0,
+		Gather = 1,
+		Frontier = 2,
+	};
+
+	class Hutchinson
+	{
+	public:
+		typedef std::atomic<std::uint64_t> Word;
+
+	private:
+		std::vector<Map> maps;
+
+		glm::ivec2 size;
+		glm::dvec4 bounds;
+
+		std::int32_t numThreads;
+
+		std::size_t wordsPerRow;
+		std::size_t numWords;
+
+		std::unique_ptr<Word[]> current;
+		std::unique_ptr<Word[]> next;
+
+		std::uint64_t count;
+		std::uint64_t changed;
+
+		Iteration iteration;
+
+		bool frontierValid;
+		std::vector<std::vector<std::uint32_t>> frontier;
+		std::vector<std::vector<std::uint32_t>> frontierPrevious;
+
+		void clear(Word* words)
+		{
+			std::size_t chunk = (this->numWords + this->numThreads - 1) / this->numThreads;
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				std::size_t begin = glm::min(this->numWords, t * chunk);
+				std::size_t end = glm::min(this->numWords, begin + chunk);
+
+				for (std::size_t i = begin; i < end; i++)
+				{
+					words[i].store(0, std::memory_order_relaxed);
+				}
+			});
+		}
+
+	public:
+		Hutchinson(const std::vector<Map>& maps, const glm::ivec2& size, const glm::dvec4& bounds, const std::int32_t numThreads = 0) :
+			maps(maps), size(size), bounds(bounds), count(0), changed(0), iteration(Iteration::Scatter), frontierValid(false)
+		{
+			this->numThreads = numThreads > 0 ? numThreads : glm::max(1, static_cast<std::int32_t>(std::thread::hardware_concurrency()));
+
+			this->frontier.resize(this->numThreads);
+			this->frontierPrevious.resize(this->numThreads);
+
+			this->wordsPerRow = (std::size_t(size.x) + 63) / 64;
+			this->numWords = this->wordsPerRow * std::size_t(size.y);
+
+			this->current.reset(new Word[this->numWords]);
+			this->next.reset(new Word[this->numWords]);
+
+			this->clear(this->current.get());
+			this->clear(this->next.get());
+		}
+
+		void setMaps(const std::vector<Map>& maps, const glm::dvec4& bounds)
+		{
+			this->maps = maps;
+			this->bounds = bounds;
+
+			this->frontierValid = false;
+		}
+
+		void initialize(const std::function<void(const std::int32_t y, std::uint64_t* row)>& fill)
+		{
+			std::atomic<std::uint64_t> count(0);
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				std::vector<std::uint64_t> row(this->wordsPerRow);
+
+				std::uint64_t local = 0;
+
+				for (std::int32_t y = t; y < this->size.y; y += this->numThreads)
+				{
+					std::fill(row.begin(), row.end(), 0ull);
+
+					fill(y, row.data());
+
+					if (this->size.x % 64 != 0)
+					{
+						row[this->wordsPerRow - 1] &= (1ull << (this->size.x % 64)) - 1ull;
+					}
+
+					for (std::size_t w = 0; w < this->wordsPerRow; w++)
+					{
+						this->current[y * this->wordsPerRow + w].store(row[w], std::memory_order_relaxed);
+
+						local += countBits(row[w]);
+					}
+				}
+
+				count += local;
+			});
+
+			this->count = count;
+			this->changed = count;
+
+			this->frontierValid = false;
+		}
+
+	private:
+		std::uint64_t plot(const std::int32_t y, const std::size_t w, std::uint64_t word, std::vector<std::uint32_t>* targets)
+		{
+			float left = static_cast<float>(this->bounds.x);
+			float bottom = static_cast<float>(this->bounds.z);
+
+			float scaleX = float(this->size.x) / static_cast<float>(this->bounds.y - this->bounds.x);
+			float scaleY = float(this->size.y) / static_cast<float>(this->bounds.w - this->bounds.z);
+
+			alignas(64) float xs[64];
+			alignas(64) std::int32_t px[64];
+			alignas(64) std::int32_t py[64];
+
+			float fy = bottom + (float(y) + 0.5f) / scaleY;
+
+			std::int32_t n = 0;
+
+			for (; word != 0; word &= word - 1ull)
+			{
+				std::int32_t x = static_cast<std::int32_t>(w * 64) + countTrailingZeros(word);
+
+				xs[n] = left + (float(x) + 0.5f) / scaleX;
+
+				n++;
+			}
+
+			std::uint64_t count = 0;
+
+			for (const auto& map : this->maps)
+			{
+				for (std::int32_t i = 0; i < n; i++)
+				{
+					float nx = map.a * xs[i] + map.b * fy + map.e;
+					float ny = map.c * xs[i] + map.d * fy + map.f;
+
+					px[i] = static_cast<std::int32_t>(std::floor((nx - left) * scaleX));
+					py[i] = static_cast<std::int32_t>(std::floor((ny - bottom) * scaleY));
+				}
+
+				for (std::int32_t i = 0; i < n; i++)
+				{
+					if (px[i] < 0 || py[i] < 0 || px[i] >= this->size.x || py[i] >= this->size.y)
+					{
+						continue;
+					}
+
+					std::size_t index = std::size_t(py[i]) * this->wordsPerRow + std::size_t(px[i] >> 6);
+
+					std::uint64_t mask = 1ull << (px[i] & 63);
+
+					if ((this->next[index].load(std::memory_order_relaxed) & mask) == 0)
+					{
+						std::uint64_t old = this->next[index].fetch_or(mask, std::memory_order_relaxed);
+
+						if ((old & mask) == 0)
+						{
+							count++;
+
+							if (old == 0 && targets)
+							{
+								targets->push_back(static_cast<std::uint32_t>(index));
+							}
+						}
+					}
+				}
+			}
+
+			return count;
+		}
+
+		std::uint64_t scatter()
+		{
+			this->clear(this->next.get());
+
+			std::atomic<std::uint64_t> count(0);
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				std::uint64_t local = 0;
+
+				for (std::int32_t y = t; y < this->size.y; y += this->numThreads)
+				{
+					for (std::size_t w = 0; w < this->wordsPerRow; w++)
+					{
+						std::uint64_t word = this->current[y * this->wordsPerRow + w].load(std::memory_order_relaxed);
+
+						if (word != 0)
+						{
+							local += this->plot(y, w, word, nullptr);
+						}
+					}
+				}
+
+				count += local;
+			});
+
+			return count;
+		}
+
+		std::uint64_t gather()
+		{
+			float left = static_cast<float>(this->bounds.x);
+			float bottom = static_cast<float>(this->bounds.z);
+
+			float scaleX = float(this->size.x) / static_cast<float>(this->bounds.y - this->bounds.x);
+			float scaleY = float(this->size.y) / static_cast<float>(this->bounds.w - this->bounds.z);
+
+			std::vector<Map> inverses;
+
+			for (const auto& map : this->maps)
+			{
+				inverses.push_back(map.getInverse());
+			}
+
+			std::atomic<std::uint64_t> count(0);
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				std::uint64_t local = 0;
+
+				for (std::int32_t y = t; y < this->size.y; y += this->numThreads)
+				{
+					float y0 = bottom + float(y) / scaleY;
+					float y1 = bottom + float(y + 1) / scaleY;
+
+					for (std::size_t w = 0; w < this->wordsPerRow; w++)
+					{
+						std::uint64_t word = 0;
+
+						std::int32_t end = glm::min(this->size.x, static_cast<std::int32_t>(w * 64 + 64));
+
+						for (std::int32_t x = static_cast<std::int32_t>(w * 64); x < end; x++)
+						{
+							float x0 = left + float(x) / scaleX;
+							float x1 = left + float(x + 1) / scaleX;
+
+							bool covered = false;
+
+							for (std::size_t k = 0; k < this->maps.size() && !covered; k++)
+							{
+								const Map& map = this->maps[k];
+								const Map& inverse = inverses[k];
+
+								glm::vec2 corners[4] = {
+									inverse.apply(glm::vec2(x0, y0)), inverse.apply(glm::vec2(x1, y0)),
+									inverse.apply(glm::vec2(x0, y1)), inverse.apply(glm::vec2(x1, y1)),
+								};
+
+								glm::vec2 minimum = glm::min(glm::min(corners[0], corners[1]), glm::min(corners[2], corners[3]));
+								glm::vec2 maximum = glm::max(glm::max(corners[0], corners[1]), glm::max(corners[2], corners[3]));
+
+								std::int32_t sx0 = glm::max(0, static_cast<std::int32_t>(std::floor((minimum.x - left) * scaleX - 0.5f)) - 1);
+								std::int32_t sy0 = glm::max(0, static_cast<std::int32_t>(std::floor((minimum.y - bottom) * scaleY - 0.5f)) - 1);
+								std::int32_t sx1 = glm::min(this->size.x - 1, static_cast<std::int32_t>(std::ceil((maximum.x - left) * scaleX - 0.5f)) + 1);
+								std::int32_t sy1 = glm::min(this->size.y - 1, static_cast<std::int32_t>(std::ceil((maximum.y - bottom) * scaleY - 0.5f)) + 1);
+
+								for (std::int32_t sy = sy0; sy <= sy1 && !covered; sy++)
+								{
+									for (std::int32_t sx = sx0; sx <= sx1 && !covered; sx++)
+									{
+										if (!this->get(sx, sy))
+										{
+											continue;
+										}
+
+										glm::vec2 target = map.apply(glm::vec2(left + (float(sx) + 0.5f) / scaleX, bottom + (float(sy) + 0.5f) / scaleY));
+
+										covered = static_cast<std::int32_t>(std::floor((target.x - left) * scaleX)) == x && static_cast<std::int32_t>(std::floor((target.y - bottom) * scaleY)) == y;
+									}
+								}
+							}
+
+							if (covered)
+							{
+								word |= 1ull << (x & 63);
+
+								local++;
+							}
+						}
+
+						this->next[y * this->wordsPerRow + w].store(word, std::memory_order_relaxed);
+					}
+				}
+
+				count += local;
+			});
+
+			return count;
+		}
+
+		void buildFrontier()
+		{
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				this->frontier[t].clear();
+				this->frontierPrevious[t].clear();
+
+				for (std::int32_t y = t; y < this->size.y; y += this->numThreads)
+				{
+					for (std::size_t w = 0; w < this->wordsPerRow; w++)
+					{
+						if (this->getRow(y, w) != 0)
+						{
+							this->frontier[t].push_back(static_cast<std::uint32_t>(y * this->wordsPerRow + w));
+						}
+					}
+				}
+			});
+
+			this->clear(this->next.get());
+
+			this->frontierValid = true;
+		}
+
+		std::uint64_t advanceFrontier(std::uint64_t& kept)
+		{
+			if (!this->frontierValid)
+			{
+				this->buildFrontier();
+			}
+			else
+			{
+				parallel(this->numThreads, [&](const std::int32_t t)
+				{
+					for (std::uint32_t index : this->frontierPrevious[t])
+					{
+						this->next[index].store(0, std::memory_order_relaxed);
+					}
+				});
+			}
+
+			std::atomic<std::uint64_t> count(0);
+			std::atomic<std::uint64_t> keptTotal(0);
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				std::vector<std::uint32_t>& targets = this->frontierPrevious[t];
+
+				targets.clear();
+
+				std::uint64_t local = 0;
+
+				for (std::uint32_t index : this->frontier[t])
+				{
+					local += this->plot(static_cast<std::int32_t>(index / this->wordsPerRow), index % this->wordsPerRow, this->current[index].load(std::memory_order_relaxed), &targets);
+				}
+
+				count += local;
+			});
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				std::sort(this->frontierPrevious[t].begin(), this->frontierPrevious[t].end());
+
+				std::uint64_t local = 0;
+
+				for (std::uint32_t index : this->frontierPrevious[t])
+				{
+					local += countBits(this->current[index].load(std::memory_order_relaxed) & this->next[index].load(std::memory_order_relaxed));
+				}
+
+				keptTotal += local;
+			});
+
+			std::swap(this->frontier, this->frontierPrevious);
+
+			kept = keptTotal;
+
+			return count;
+		}
+
+	public:
+		void setIteration(const Iteration iteration)
+		{
+			this->iteration = iteration;
+
+			if (iteration == Iteration::Gather && !isGatherable(this->maps, this->size, this->bounds))
+			{
+				this->iteration = Iteration::Scatter;
+			}
+
+			this->frontierValid = false;
+		}
+
+		Iteration getIteration() const
+		{
+			return this->iteration;
+		}
+
+		std::size_t getFrontierWords() const
+		{
+			std::size_t size = 0;
+
+			for (const auto& words : this->frontier)
+			{
+				size += words.size();
+			}
+
+			return this->frontierValid ? size : 0;
+		}
+
+		void iterate()
+		{
+			if (this->iteration == Iteration::Frontier)
+			{
+				std::uint64_t kept = 0;
+
+				std::uint64_t count = this->advanceFrontier(kept);
+
+				std::swap(this->current, this->next);
+
+				this->changed = this->count + count - 2 * kept;
+
+				this->count = count;
+
+				return;
+			}
+
+			this->frontierValid = false;
+
+			std::uint64_t count = this->iteration == Iteration::Gather ? this->gather() : this->scatter();
+
+			std::swap(this->current, this->next);
+
+			std::atomic<std::uint64_t> kept(0);
+
+			std::size_t chunk = (this->numWords + this->numThreads - 1) / this->numThreads;
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				std::size_t begin = glm::min(this->numWords, t * chunk);
+				std::size_t end = glm::min(this->numWords, begin + chunk);
+
+				std::uint64_t local = 0;
+
+				for (std::size_t i = begin; i < end; i++)
+				{
+					local += countBits(this->current[i].load(std::memory_order_relaxed) & this->next[i].load(std::memory_order_relaxed));
+				}
+
+				kept += local;
+			});
+
+			this->changed = this->count + count - 2 * kept;
+
+			this->count = count;
+		}
+
+		bool get(const std::int32_t x, const std::int32_t y) const
+		{
+			return (this->current[std::size_t(y) * this->wordsPerRow + std::size_t(x >> 6)].load(std::memory_order_relaxed) >> (x & 63)) & 1ull;
+		}
+
+		std::uint64_t getRow(const std::int32_t y, const std::size_t w) const
+		{
+			return this->current[std::size_t(y) * this->wordsPerRow + w].load(std::memory_order_relaxed);
+		}
+
+		const glm::ivec2& getSize() const
+		{
+			return this->size;
+		}
+
+		std::size_t getWordsPerRow() const
+		{
+			return this->wordsPerRow;
+		}
+
+		std::uint64_t getCount() const
+		{
+			return this->count;
+		}
+
+		std::uint64_t getChanged() const
+		{
+			return this->changed;
+		}
+
+		std::int32_t getNumThreads() const
+		{
+			return this->numThreads;
+		}
+	};
+
+	class TileStore
+	{
+	public:
+		static constexpr std::int32_t tileSize = 256;
+		static constexpr std::size_t wordsPerTileRow = tileSize / 64;
+		static constexpr std::size_t wordsPerTile = wordsPerTileRow * tileSize;
+
+	private:
+		struct Tile
+		{
+			std::atomic<std::uint64_t> words[wordsPerTile];
+		};
+
+		glm::ivec2 size;
+		glm::ivec2 numTiles;
+
+		std::unique_ptr<std::atomic<Tile*>[]> tiles;
+		std::atomic<std::size_t> numAllocated;
+
+		Tile* getTile(const std::int32_t tx, const std::int32_t ty) const
+		{
+			return this->tiles[std::size_t(ty) * std::size_t(this->numTiles.x) + std::size_t(tx)].load(std::memory_order_acquire);
+		}
+
+		Tile* allocateTile(const std::int32_t tx, const std::int32_t ty)
+		{
+			auto& slot = this->tiles[std::size_t(ty) * std::size_t(this->numTiles.x) + std::size_t(tx)];
+
+			Tile* tile = slot.load(std::memory_order_acquire);
+
+			if (tile)
+			{
+				return tile;
+			}
+
+			Tile* allocated = new Tile;
+
+			for (auto& word : allocated->words)
+			{
+				word.store(0, std::memory_order_relaxed);
+			}
+
+			if (slot.compare_exchange_strong(tile, allocated, std::memory_order_acq_rel))
+			{
+				this->numAllocated++;
+
+				return allocated;
+			}
+
+			delete allocated;
+
+			return tile;
+		}
+
+	public:
+		TileStore(const glm::ivec2& size = glm::ivec2(0)) :
+			size(0), numTiles(0), numAllocated(0)
+		{
+			this->reset(size);
+		}
+
+		~TileStore()
+		{
+			this->clear();
+		}
+
+		TileStore(const TileStore&) = delete;
+		TileStore& operator=(const TileStore&) = delete;
+
+		void reset(const glm::ivec2& size)
+		{
+			this->clear();
+
+			this->size = glm::max(size, glm::ivec2(0));
+			this->numTiles = (this->size + tileSize - 1) / tileSize;
+
+			this->tiles.reset(new std::atomic<Tile*>[std::size_t(this->numTiles.x) * std::size_t(this->numTiles.y)]);
+
+			for (std::size_t i = 0; i < std::size_t(this->numTiles.x) * std::size_t(this->numTiles.y); i++)
+			{
+				this->tiles[i].store(nullptr, std::memory_order_relaxed);
+			}
+		}
+
+		void clear()
+		{
+			if (this->tiles)
+			{
+				for (std::size_t i = 0; i < std::size_t(this->numTiles.x) * std::size_t(this->numTiles.y); i++)
+				{
+					delete this->tiles[i].exchange(nullptr);
+				}
+			}
+
+			this->numAllocated = 0;
+		}
+
+		void set(const std::int32_t x, const std::int32_t y)
+		{
+			Tile* tile = this->allocateTile(x / tileSize, y / tileSize);
+
+			std::size_t index = std::size_t(y % tileSize) * tileSize + std::size_t(x % tileSize);
+
+			tile->words[index >> 6].fetch_or(1ull << (index & 63), std::memory_order_relaxed);
+		}
+
+		bool get(const std::int32_t x, const std::int32_t y) const
+		{
+			Tile* tile = this->getTile(x / tileSize, y / tileSize);
+
+			std::size_t index = std::size_t(y % tileSize) * tileSize + std::size_t(x % tileSize);
+
+			return tile && (tile->words[index >> 6].load(std::memory_order_relaxed) >> (index & 63)) & 1ull;
+		}
+
+		bool hasTile(const std::int32_t tx, const std::int32_t ty) const
+		{
+			return this->getTile(tx, ty) != nullptr;
+		}
+
+		std::uint64_t getRow(const std::int32_t y, const std::size_t w) const
+		{
+			Tile* tile = this->getTile(static_cast<std::int32_t>(w / wordsPerTileRow), y / tileSize);
+
+			return tile ? tile->words[std::size_t(y % tileSize) * wordsPerTileRow + w % wordsPerTileRow].load(std::memory_order_relaxed) : 0ull;
+		}
+
+		const glm::ivec2& getSize() const
+		{
+			return this->size;
+		}
+
+		std::size_t getWordsPerRow() const
+		{
+			return std::size_t(this->numTiles.x) * wordsPerTileRow;
+		}
+
+		const glm::ivec2& getNumTiles() const
+		{
+			return this->numTiles;
+		}
+
+		std::size_t getNumAllocated() const
+		{
+			return this->numAllocated;
+		}
+
+		std::size_t getMemory() const
+		{
+			return this->numAllocated * sizeof(Tile) + std::size_t(this->numTiles.x) * std::size_t(this->numTiles.y) * sizeof(std::atomic<Tile*>);
+		}
+	};
+
+	class CodeTree
+	{
+	private:
+		struct Node
+		{
+			glm::dmat2 matrix;
+			glm::dvec2 offset;
+		};
+
+		std::vector<Map> maps;
+
+		glm::dvec2 center;
+		double radius;
+
+		std::int32_t numThreads;
+		std::uint64_t maxNodes;
+
+		glm::ivec2 size;
+		glm::dvec4 bounds;
+
+		TileStore coverage;
+
+		std::uint64_t numNodes;
+		std::uint64_t numCulled;
+
+		bool isVisible(const glm::dvec2& center, const double radius) const
+		{
+			return center.x + radius >= this->bounds.x && center.x - radius <= this->bounds.y && center.y + radius >= this->bounds.z && center.y - radius <= this->bounds.w;
+		}
+
+		void traverse(std::vector<Node>& stack, std::uint64_t& numNodes, std::uint64_t& numCulled, const std::uint64_t maxNodes)
+		{
+			double pixelSize = glm::max(glm::abs(this->bounds.y - this->bounds.x) / this->size.x, glm::abs(this->bounds.w - this->bounds.z) / this->size.y);
+
+			while (!stack.empty() && numNodes < maxNodes)
+			{
+				Node node = stack.back();
+
+				stack.pop_back();
+
+				numNodes++;
+
+				glm::dvec2 center = node.matrix * this->center + node.offset;
+
+				double radius = getNorm(node.matrix) * this->radius;
+
+				if (!this->isVisible(center, radius))
+				{
+					numCulled++;
+
+					continue;
+				}
+
+				if (radius <= 0.5 * pixelSize)
+				{
+					glm::dvec2 screen = (center - glm::dvec2(this->bounds.x, this->bounds.z)) / glm::dvec2(this->bounds.y - this->bounds.x, this->bounds.w - this->bounds.z);
+
+					glm::ivec2 index = glm::ivec2(glm::floor(screen * glm::dvec2(this->size)));
+
+					if (index.x >= 0 && index.y >= 0 && index.x < this->size.x && index.y < this->size.y)
+					{
+						this->coverage.set(index.x, index.y);
+					}
+
+					continue;
+				}
+
+				for (const auto& map : this->maps)
+				{
+					stack.push_back({ node.matrix * getMatrix(map), node.matrix * glm::dvec2(map.e, map.f) + node.offset });
+				}
+			}
+		}
+
+	public:
+		CodeTree(const std::vector<Map>& maps, const std::int32_t numThreads = 0, const std::uint64_t maxNodes = std::uint64_t(1) << 28) :
+			maps(maps), maxNodes(maxNodes), size(0), bounds(0.0), numNodes(0), numCulled(0)
+		{
+			if (this->maps.size() == 0)
+			{
+				throw std::runtime_error("IFS-Error: No maps given.");
+			}
+
+			this->numThreads = numThreads > 0 ? numThreads : glm::max(1, static_cast<std::int32_t>(std::thread::hardware_concurrency()));
+
+			if (!getBoundingBall(this->maps, this->center, this->radius))
+			{
+				this->radius = std::numeric_limits<double>::infinity();
+			}
+		}
+
+		void render(const glm::ivec2& size, const glm::dvec4& bounds)
+		{
+			this->size = size;
+			this->bounds = bounds;
+
+			this->coverage.reset(size);
+
+			this->numNodes = 0;
+			this->numCulled = 0;
+
+			if (!this->isValid() || size.x <= 0 || size.y <= 0)
+			{
+				return;
+			}
+
+			std::vector<Node> roots = { { glm::dmat2(1.0), glm::dvec2(0.0) } };
+
+			std::uint64_t numNodes = 0;
+			std::uint64_t numCulled = 0;
+
+			while (roots.size() > 0 && roots.size() < std::size_t(16 * this->numThreads))
+			{
+				std::vector<Node> stack = { roots.back() };
+
+				roots.pop_back();
+
+				this->traverse(stack, numNodes, numCulled, numNodes + 1);
+
+				roots.insert(roots.end(), stack.begin(), stack.end());
+			}
+
+			std::vector<std::uint64_t> nodes(this->numThreads, 0);
+			std::vector<std::uint64_t> culled(this->numThreads, 0);
+
+			parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				for (std::size_t i = t; i < roots.size(); i += this->numThreads)
+				{
+					std::vector<Node> stack = { roots[i] };
+
+					this->traverse(stack, nodes[t], culled[t], this->maxNodes / this->numThreads);
+				}
+			});
+
+			this->numNodes = numNodes;
+			this->numCulled = numCulled;
+
+			for (std::int32_t t = 0; t < this->numThreads; t++)
+			{
+				this->numNodes += nodes[t];
+				this->numCulled += culled[t];
+			}
+		}
+
+		bool isValid() const
+		{
+			return std::isfinite(this->radius);
+		}
+
+		const TileStore& getCoverage() const
+		{
+			return this->coverage;
+		}
+
+		const glm::dvec2& getCenter() const
+		{
+			return this->center;
+		}
+
+		double getRadius() const
+		{
+			return this->radius;
+		}
+
+		std::uint64_t getNumNodes() const
+		{
+			return this->numNodes;
+		}
+
+		std::uint64_t getNumCulled() const
+		{
+			return this->numCulled;
+		}
+
+		std::int32_t getNumThreads() const
+		{
+			return this->numThreads;
+		}
+	};
+
+	class BoxCounter
+	{
+	public:
+		static constexpr std::int32_t tileSize = 128;
+
+	private:
+		glm::ivec2 size;
+
+		std::size_t wordsPerRow;
+		std::vector<std::uint64_t> words;
+
+		std::vector<glm::ivec2> levelSizes;
+		std::vector<std::vector<std::uint32_t>> counts;
+		std::vector<std::uint64_t> boxes;
+
+		std::uint64_t numChanged;
+
+		void change(const std::int32_t x, const std::int32_t y, const bool set)
+		{
+			this->boxes[0] += set ? 1 : std::uint64_t(-1);
+
+			for (std::size_t level = 1; level < this->levelSizes.size(); level++)
+			{
+				std::uint32_t& count = this->counts[level][std::size_t(y >> level) * std::size_t(this->levelSizes[level].x) + std::size_t(x >> level)];
+
+				if (set)
+				{
+					this->boxes[level] += count++ == 0 ? 1 : 0;
+				}
+				else
+				{
+					this->boxes[level] -= --count == 0 ? 1 : 0;
+				}
+			}
+		}
+
+	public:
+		BoxCounter(const glm::ivec2& size) :
+			size(glm::max(size, glm::ivec2(1))), numChanged(0)
+		{
+			this->wordsPerRow = (std::size_t(this->size.x) + 63) / 64;
+
+			this->words.resize(this->wordsPerRow * std::size_t(this->size.y), 0ull);
+
+			for (glm::ivec2 levelSize = this->size; ; levelSize = (levelSize + 1) / 2)
+			{
+				this->levelSizes.push_back(levelSize);
+
+				this->counts.emplace_back(this->levelSizes.size() > 1 ? std::size_t(levelSize.x) * std::size_t(levelSize.y) : 0, 0u);
+
+				if (levelSize.x == 1 && levelSize.y == 1)
+				{
+					break;
+				}
+			}
+
+			this->boxes.resize(this->levelSizes.size(), 0);
+		}
+
+		void update(const std::function<void(const std::int32_t y, std::uint64_t* row)>& fill, const std::vector<std::uint8_t>& dirtyTiles = { })
+		{
+			std::vector<std::uint64_t> row(this->wordsPerRow);
+
+			glm::ivec2 numTiles = this->getNumTiles();
+
+			std::size_t wordsPerTile = tileSize / 64;
+
+			this->numChanged = 0;
+
+			for (std::int32_t ty = 0; ty < numTiles.y; ty++)
+			{
+				const std::uint8_t* dirtyRow = dirtyTiles.size() > 0 ? dirtyTiles.data() + std::size_t(ty) * std::size_t(numTiles.x) : nullptr;
+
+				if (dirtyRow && std::find(dirtyRow, dirtyRow + numTiles.x, std::uint8_t(1)) == dirtyRow + numTiles.x)
+				{
+					continue;
+				}
+
+				for (std::int32_t y = ty * tileSize; y < glm::min(this->size.y, (ty + 1) * tileSize); y++)
+				{
+					fill(y, row.data());
+
+					if (this->size.x % 64 != 0)
+					{
+						row[this->wordsPerRow - 1] &= (1ull << (this->size.x % 64)) - 1ull;
+					}
+
+					std::uint64_t* previous = this->words.data() + std::size_t(y) * this->wordsPerRow;
+
+					for (std::size_t w = 0; w < this->wordsPerRow; w++)
+					{
+						if (dirtyRow && !dirtyRow[w / wordsPerTile])
+						{
+							continue;
+						}
+
+						for (std::uint64_t changed = row[w] ^ previous[w]; changed != 0; changed &= changed - 1ull)
+						{
+							std::int32_t bit = countTrailingZeros(changed);
+
+							this->change(static_cast<std::int32_t>(w * 64) + bit, y, (row[w] >> bit) & 1ull);
+
+							this->numChanged++;
+						}
+
+						previous[w] = row[w];
+					}
+				}
+			}
+		}
+
+		double getDimension(const std::uint64_t minBoxes = 16, std::int32_t* firstLevel = nullptr, std::int32_t* lastLevel = nullptr) const
+		{
+			double sumX = 0.0, sumY = 0.0, sumXX = 0.0, sumXY = 0.0;
+
+			std::int32_t n = 0;
+			std::int32_t first = -1;
+			std::int32_t last = -1;
+
+			for (std::size_t level = 0; level < this->boxes.size(); level++)
+			{
+				if (this->boxes[level] < minBoxes)
+				{
+					continue;
+				}
+
+				double x = double(level);
+				double y = std::log2(double(this->boxes[level]));
+
+				sumX += x;
+				sumY += y;
+				sumXX += x * x;
+				sumXY += x * y;
+
+				first = first < 0 ? static_cast<std::int32_t>(level) : first;
+				last = static_cast<std::int32_t>(level);
+
+				n++;
+			}
+
+			if (firstLevel)
+			{
+				*firstLevel = first;
+			}
+
+			if (lastLevel)
+			{
+				*lastLevel = last;
+			}
+
+			double denominator = double(n) * sumXX - sumX * sumX;
+
+			if (n < 2 || denominator <= 0.0)
+			{
+				return std::numeric_limits<double>::quiet_NaN();
+			}
+
+			return -(double(n) * sumXY - sumX * sumY) / denominator;
+		}
+
+		std::int32_t getNumLevels() const
+		{
+			return static_cast<std::int32_t>(this->boxes.size());
+		}
+
+		std::uint64_t getBoxes(const std::int32_t level) const
+		{
+			return this->boxes[level];
+		}
+
+		std::uint64_t getNumChanged() const
+		{
+			return this->numChanged;
+		}
+
+		const glm::ivec2& getSize() const
+		{
+			return this->size;
+		}
+
+		glm::ivec2 getNumTiles() const
+		{
+			return (this->size + tileSize - 1) / tileSize;
+		}
+	};
+}
@@ -5,23 +5,32 @@
 #include <clocale>
 #include <iomanip>
 #include <sstream>
+#include <fstream>
 #include <string>
 #include <cstring>
+#include <cstdlib>
 #include <vector>
+#include <queue>
 #include <array>
 #include <set>
+#include <map>
 #include <memory>
 
 #include <chrono>
 #include <thread>
+#include <mutex>
+#include <atomic>
+#include <future>
 
 #include <cmath>
 #include <algorithm>
+#include <numeric>
 
 #include <exception>
 #include <limits>
 
 #include <functional>
+#include <utility>
 
 #include <imgui.h>
 #include <imgui_impl_glfw.h>
@@ -74,6 +74,8 @@ std::vector<FractalSelector> fractalSelectors(
 		FractalSelector::create<fractals::SierpinskiTriangle>("Sierpinski Triangle", glm::ivec2(4096, 4096)),
 		FractalSelector::create<fractals::MapleLeaf>("Maple Leaf", glm::ivec2(4096, 4096)),
 		FractalSelector::create<fractals::Mandelbrot>("Mandelbrot", glm::ivec2(1920, 1080), viewport, 2),
+		FractalSelector::create<fractals::Julia>("Julia", glm::ivec2(4096, 4096)),
+		FractalSelector::create<fractals::JuliaAtlas>("Julia Atlas", glm::ivec2(24, 24), 64),
 	}
 );
 
@@ -130,6 +132,45 @@ void resetViewport()
 	}	
 }
 
+void info()
+{
+	if (fractal)
+	{
+		try
+		{
+			fractal->info();
+		}
+		catch(const std::exception& error)
+		{
+			fractal = nullptr;
+
+			std::cerr << error.what() << std::endl;
+		}
+	}
+}
+
+bool converged()
+{
+	return fractal && fractal->converged();
+}
+
+void navigate()
+{
+	if (fractal)
+	{
+		try
+		{
+			fractal->navigate(viewport);
+		}
+		catch(const std::exception& error)
+		{
+			fractal = nullptr;
+
+			std::cerr << error.what() << std::endl;
+		}
+	}
+}
+
 void options()
 {
 	if (fractal)
@@ -292,8 +333,211 @@ void dropCallback(GLFWwindow* window, int count, const char** paths)
 	}
 }
 
-int main()
+bool getAffinePreset(const std::string& name, fractals::Affine::Fractal& affine)
+{
+	if (name == "fern")
+	{
+		affine = fractals::Affine::createBarnsleyFern();
+	}
+	else if (name == "sierpinski")
+	{
+		affine = fractals::Affine::createSierpinskiTriangle();
+	}
+	else if (name == "maple")
+	{
+		affine = fractals::Affine::createMapleLeaf();
+	}
+	else
+	{
+		std::cerr << "Unknown fractal: " << name << std::endl;
+
+		return false;
+	}
+
+	return true;
+}
+
+template <typename T>
+bool parseArgument(const std::string& argument, T& value)
+{
+	try
+	{
+		std::size_t length = 0;
+
+		if (std::is_integral<T>::value)
+		{
+			value = static_cast<T>(std::stoi(argument, &length));
+		}
+		else
+		{
+			value = static_cast<T>(std::stod(argument, &length));
+		}
+
+		return length == argument.size() && value > T(0);
+	}
+	catch (const std::invalid_argument&)
+	{
+		return false;
+	}
+	catch (const std::out_of_range&)
+	{
+		return false;
+	}
+}
+
+int renderChaosGame(const std::vector<std::string>& arguments)
+{
+	glm::ivec2 size(0);
+
+	double numPoints = 0.0;
+
+	if (arguments.size() != 5 || !parseArgument(arguments[1], size.x) || !parseArgument(arguments[2], size.y) || !parseArgument(arguments[3], numPoints))
+	{
+		std::cerr << "Usage: FractalRenderer --chaos-game <fern|sierpinski|maple> <width> <height> <points> <output>" << std::endl;
+
+		return 1;
+	}
+
+	fractals::Affine::Fractal affine;
+
+	if (!getAffinePreset(arguments[0], affine))
+	{
+		return 1;
+	}
+
+	std::uint64_t points = static_cast<std::uint64_t>(glm::min(numPoints, 1e18));
+
+	try
+	{
+		ifs::ChaosGame chaosGame(fractals::Affine::toMaps(affine.affineTransforms), size, affine.viewport.viewport, 0, std::size_t(1) << 32);
+
+		std::uint64_t chunk = std::uint64_t(1) << 30;
+
+		auto begin = std::chrono::steady_clock::now();
+
+		for (std::uint64_t done = 0; done < points; done += chunk)
+		{
+			chaosGame.run(glm::min(chunk, points - done));
+
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+			std::cout << chaosGame.getNumPoints() << " points, " << chaosGame.getNumPoints() / seconds << " points per second" << std::endl;
+		}
+
+		const auto& hits = chaosGame.getHits();
+
+		std::uint64_t maxHits = std::max<std::uint64_t>(1u, *std::max_element(hits.begin(), hits.end()));
+
+		img::ImagePtr image = img::make(size.x, size.y);
+
+		for (std::size_t i = 0; i < hits.size(); i++)
+		{
+			int value = static_cast<int>(255.0 * std::log1p(double(hits[i])) / std::log1p(double(maxHits)) + 0.5);
+
+			image->pixels[i] = value | (value << 8) | (value << 16) | (0xFF << 24);
+		}
+
+		if (!img::save(arguments[4], image, true))
+		{
+			std::cerr << "Failed to save " << arguments[4] << std::endl;
+
+			return 1;
+		}
+	}
+	catch (const std::exception& error)
+	{
+		std::cerr << error.what() << std::endl;
+
+		return 1;
+	}
+
+	return 0;
+}
+
+int renderCodeTree(const std::vector<std::string>& arguments)
+{
+	glm::ivec2 size(0);
+
+	if (arguments.size() != 4 || !parseArgument(arguments[1], size.x) || !parseArgument(arguments[2], size.y))
+	{
+		std::cerr << "Usage: FractalRenderer --code-tree <fern|sierpinski|maple> <width> <height> <output.pbm>" << std::endl;
+
+		return 1;
+	}
+
+	fractals::Affine::Fractal affine;
+
+	if (!getAffinePreset(arguments[0], affine))
+	{
+		return 1;
+	}
+
+	try
+	{
+		ifs::CodeTree codeTree(fractals::Affine::toMaps(affine.affineTransforms), 0, std::numeric_limits<std::uint64_t>::max());
+
+		auto begin = std::chrono::steady_clock::now();
+
+		codeTree.render(size, affine.viewport.viewport);
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+
+		const auto& coverage = codeTree.getCoverage();
+
+		std::cout << codeTree.getNumNodes() << " nodes in " << seconds << " seconds, " << coverage.getNumAllocated() << " of " << std::size_t(coverage.getNumTiles().x) * std::size_t(coverage.getNumTiles().y) << " tiles, " << coverage.getMemory() / 1048576.0 << " MiB" << std::endl;
+
+		std::ofstream file(arguments[3], std::ios::binary);
+
+		file << "P4\n" << size.x << " " << size.y << "\n";
+
+		std::vector<char> row((std::size_t(size.x) + 7) / 8);
+
+		for (std::int32_t y = size.y - 1; y >= 0; y--)
+		{
+			std::fill(row.begin(), row.end(), 0);
+
+			for (std::size_t w = 0; w < coverage.getWordsPerRow(); w++)
+			{
+				for (std::uint64_t word = coverage.getRow(y, w); word != 0; word &= word - 1ull)
+				{
+					std::size_t x = w * 64 + ifs::countTrailingZeros(word);
+
+					row[x >> 3] |= static_cast<char>(0x80 >> (x & 7));
+				}
+			}
+
+			file.write(row.data(), row.size());
+		}
+
+		if (!file)
+		{
+			std::cerr << "Failed to save " << arguments[3] << std::endl;
+
+			return 1;
+		}
+	}
+	catch (const std::exception& error)
+	{
+		std::cerr << error.what() << std::endl;
+
+		return 1;
+	}
+
+	return 0;
+}
+
+int main(int argc, char** argv)
 {
+	if (argc > 1 && std::string(argv[1]) == "--chaos-game")
+	{
+		return renderChaosGame(std::vector<std::string>(argv + 2, argv + argc));
+	}
+
+	if (argc > 1 && std::string(argv[1]) == "--code-tree")
+	{
+		return renderCodeTree(std::vector<std::string>(argv + 2, argv + argc));
+	}
+
 	RAIIWrapper<bool> glfwIsInit(static_cast<bool>(glfwInit()), [](const bool) { glfwTerminate(); });
 
 	if (!glfwIsInit)
@@ -505,6 +749,8 @@ int main()
 				ImGui::SliderInt("Iterations per Frame", &iterationsPerFrame, 1, 1000);
 
 				options();
+
+				navigate();
 			}
 
 			if (ImGui::CollapsingHeader("Viewport", ImGuiTreeNodeFlags_DefaultOpen))
@@ -528,6 +774,8 @@ int main()
 			if (ImGui::CollapsingHeader("Info", ImGuiTreeNodeFlags_DefaultOpen))
 			{
 				ImGui::Text("Framerate: %.1f FPS (%.3f ms)", ImGui::GetIO().Framerate, 1000.0f / ImGui::GetIO().Framerate);
+
+				info();
 			}
 
 			ImGui::End();
@@ -536,7 +784,7 @@ int main()
 
 			ImGui::EndFrame();
 
-			if (autoIterate)
+			if (autoIterate && !converged())
 			{
 				iterate(iterationsPerFrame);
 			}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include "OpenGLHelper.hpp"
+#include "Formula.hpp"
+
+namespace nucleus
+{
+	struct Minibrot
+	{
+		std::int32_t period = 0;
+
+		glm::dvec2 nucleus = glm::dvec2(0.0);
+		glm::dvec2 size = glm::dvec2(0.0);
+	};
+
+	inline bool isQuadratic(const std::string& source)
+	{
+		std::string error;
+
+		auto expression = formula::Expression::parse(source, { formula::Variable("z"), formula::Variable("c") }, error);
+
+		if (!expression)
+		{
+			return false;
+		}
+
+		double zRe[3] = { 0.3, -1.1, 0.7 };
+		double zIm[3] = { 0.2, 0.5, -1.3 };
+		double cRe[3] = { -0.4, 0.25, 1.5 };
+		double cIm[3] = { 0.6, -0.1, 0.9 };
+
+		double resultRe[3];
+		double resultIm[3];
+
+		expression->compileProgram().evaluate({ zRe, cRe }, { zIm, cIm }, 3, resultRe, resultIm);
+
+		for (std::size_t i = 0; i < 3; i++)
+		{
+			glm::dvec2 z(zRe[i], zIm[i]);
+
+			glm::dvec2 expected = formula::detail::multiply(z, z) + glm::dvec2(cRe[i], cIm[i]);
+
+			if (glm::length(glm::dvec2(resultRe[i], resultIm[i]) - expected) > 1e-9)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	inline bool surroundsOrigin(const glm::dvec2* polygon, const std::size_t count)
+	{
+		bool inside = false;
+
+		for (std::size_t i = 0, j = count - 1; i < count; j = i++)
+		{
+			const glm::dvec2& a = polygon[i];
+			const glm::dvec2& b = polygon[j];
+
+			if ((a.y > 0.0) != (b.y > 0.0))
+			{
+				double x = a.x - a.y * (b.x - a.x) / (b.y - a.y);
+
+				if (x > 0.0)
+				{
+					inside = !inside;
+				}
+			}
+		}
+
+		return inside;
+	}
+
+	inline std::int32_t findPeriod(const glm::dvec2& center, const glm::dvec2& radius, const std::int32_t maxPeriod)
+	{
+		glm::dvec2 corners[4] = {
+			center + glm::dvec2(-radius.x, -radius.y),
+			center + glm::dvec2(radius.x, -radius.y),
+			center + glm::dvec2(radius.x, radius.y),
+			center + glm::dvec2(-radius.x, radius.y),
+		};
+
+		glm::dvec2 z[4] = { glm::dvec2(0.0), glm::dvec2(0.0), glm::dvec2(0.0), glm::dvec2(0.0) };
+
+		for (std::int32_t period = 1; period <= maxPeriod; period++)
+		{
+			for (std::int32_t k = 0; k < 4; k++)
+			{
+				z[k] = formula::detail::multiply(z[k], z[k]) + corners[k];
+
+				if (glm::dot(z[k], z[k]) > 1e100)
+				{
+					return 0;
+				}
+			}
+
+			if (surroundsOrigin(z, 4))
+			{
+				return period;
+			}
+		}
+
+		return 0;
+	}
+
+	inline bool findNucleus(glm::dvec2& c, const std::int32_t period, const std::int32_t maxSteps = 64)
+	{
+		double epsilon = std::numeric_limits<double>::epsilon();
+
+		double previous = std::numeric_limits<double>::infinity();
+
+		for (std::int32_t step = 0; step < maxSteps; step++)
+		{
+			glm::dvec2 z(0.0);
+			glm::dvec2 dz(0.0);
+
+			for (std::int32_t i = 0; i < period; i++)
+			{
+				dz = 2.0 * formula::detail::multiply(z, dz) + glm::dvec2(1.0, 0.0);
+				z = formula::detail::multiply(z, z) + c;
+			}
+
+			if (dz == glm::dvec2(0.0))
+			{
+				return false;
+			}
+
+			glm::dvec2 delta = formula::detail::divide(z, dz);
+
+			c -= delta;
+
+			if (!std::isfinite(c.x) || !std::isfinite(c.y))
+			{
+				return false;
+			}
+
+			double length = glm::length(delta);
+			double scale = glm::max(1.0, glm::length(c));
+
+			if (length <= 4.0 * epsilon * double(period) * scale || (length >= previous && previous <= std::sqrt(epsilon) * scale))
+			{
+				return true;
+			}
+
+			previous = length;
+		}
+
+		return false;
+	}
+
+	inline glm::dvec2 estimateSize(const glm::dvec2& c, const std::int32_t period)
+	{
+		glm::dvec2 z(0.0);
+		glm::dvec2 l(1.0, 0.0);
+		glm::dvec2 b(1.0, 0.0);
+
+		for (std::int32_t i = 1; i < period; i++)
+		{
+			z = formula::detail::multiply(z, z) + c;
+			l = 2.0 * formula::detail::multiply(z, l);
+			b += formula::detail::divide(glm::dvec2(1.0, 0.0), l);
+		}
+
+		return formula::detail::divide(glm::dvec2(1.0, 0.0), formula::detail::multiply(b, formula::detail::multiply(l, l)));
+	}
+
+	inline bool locate(const glm::dvec2& center, const glm::dvec2& radius, const std::int32_t maxPeriod, Minibrot& minibrot, const std::int32_t period = 0)
+	{
+		minibrot.period = period > 0 ? period : findPeriod(center, radius, maxPeriod);
+
+		if (minibrot.period <= 0)
+		{
+			return false;
+		}
+
+		minibrot.nucleus = center;
+
+		if (!findNucleus(minibrot.nucleus, minibrot.period))
+		{
+			return false;
+		}
+
+		minibrot.size = estimateSize(minibrot.nucleus, minibrot.period);
+
+		return std::isfinite(minibrot.size.x) && std::isfinite(minibrot.size.y);
+	}
+}
@@ -106,7 +106,7 @@ namespace gl
 		}
 	}
 
-	inline RAIIWrapper<GLuint> compileAndLinkShaders(const std::string& vertexShaderCode, const std::string& fragmentShaderCode)
+	inline RAIIWrapper<GLuint> compileAndLinkShaders(const std::string& vertexShaderCode, const std::string& fragmentShaderCode, const std::vector<std::string>& feedbackVaryings = { })
 	{
 		RAIIWrapper<GLuint> program(glCreateProgram(), glDeleteProgram);
 
@@ -156,6 +156,18 @@ namespace gl
 		glAttachShader(program, vertexShader);
 		glAttachShader(program, fragmentShader);
 
+		if (feedbackVaryings.size() > 0)
+		{
+			std::vector<const GLchar*> varyings;
+
+			for (const auto& varying : feedbackVaryings)
+			{
+				varyings.push_back(varying.c_str());
+			}
+
+			glTransformFeedbackVaryings(program, static_cast<GLsizei>(varyings.size()), varyings.data(), GL_INTERLEAVED_ATTRIBS);
+		}
+
 		glLinkProgram(program);
 
 		glGetProgramiv(program, GL_LINK_STATUS, &success);
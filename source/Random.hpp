@@ -0,0 +1,69 @@
+#pragma once
+
+#include "OpenGLHelper.hpp"
+
+namespace rng
+{
+	inline glm::uvec2 philox2x32(glm::uvec2 counter, std::uint32_t key)
+	{
+		for (std::int32_t i = 0; i < 10; i++)
+		{
+			std::uint64_t product = std::uint64_t(0xD256D193u) * std::uint64_t(counter.x);
+
+			std::uint32_t hi = static_cast<std::uint32_t>(product >> 32);
+			std::uint32_t lo = static_cast<std::uint32_t>(product);
+
+			counter = glm::uvec2(hi ^ key ^ counter.y, lo);
+
+			key += 0x9E3779B9u;
+		}
+
+		return counter;
+	}
+
+	inline float toFloat(const std::uint32_t value)
+	{
+		return static_cast<float>(value >> 8) * (1.0f / 16777216.0f);
+	}
+
+	inline glm::vec2 random2(const std::uint32_t index, const std::uint32_t iteration, const std::uint32_t seed)
+	{
+		glm::uvec2 bits = philox2x32(glm::uvec2(index, iteration), seed);
+
+		return glm::vec2(toFloat(bits.x), toFloat(bits.y));
+	}
+
+	inline std::string getGLSLFunctions()
+	{
+		return CODE(
+			uvec2 philox2x32(uvec2 counter, uint key)
+			{
+				for (int i = 0; i < 10; i++)
+				{
+					uint hi;
+					uint lo;
+
+					umulExtended(0xD256D193u, counter.x, hi, lo);
+
+					counter = uvec2(hi ^ key ^ counter.y, lo);
+
+					key += 0x9E3779B9u;
+				}
+
+				return counter;
+			}
+
+			float toFloat(uint value)
+			{
+				return float(value >> 8u) * (1.0 / 16777216.0);
+			}
+
+			vec2 random2(uint index, uint iteration, uint seed)
+			{
+				uvec2 bits = philox2x32(uvec2(index, iteration), seed);
+
+				return vec2(toFloat(bits.x), toFloat(bits.y));
+			}
+		);
+	}
+}
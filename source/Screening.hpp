@@ -0,0 +1,331 @@
+#pragma once
+
+#include "IFS.hpp"
+
+namespace screening
+{
+	struct Settings
+	{
+		std::int32_t numCandidates = 10000;
+		std::int32_t numResults = 16;
+		std::int32_t resolution = 64;
+		std::int32_t minMaps = 2;
+		std::int32_t maxMaps = 5;
+		std::int32_t numPoints = 1 << 15;
+		float minScale = 0.2f;
+		float maxScale = 0.7f;
+		float maxShear = 0.3f;
+		float maxContraction = 0.9f;
+		float targetCoverage = 0.2f;
+		float targetDimension = 1.6f;
+		float weightCoverage = 1.0f;
+		float weightDimension = 1.0f;
+		float weightSymmetry = 1.0f;
+		std::int32_t seed = 0;
+	};
+
+	struct Result
+	{
+		std::uint64_t index = 0;
+
+		std::vector<ifs::Map> maps;
+
+		glm::dvec4 bounds = glm::dvec4(0.0);
+
+		double coverage = 0.0;
+		double dimension = 0.0;
+		double symmetry = 0.0;
+		double score = 0.0;
+
+		bool operator>(const Result& other) const
+		{
+			return this->score > other.score || (this->score == other.score && this->index < other.index);
+		}
+	};
+
+	inline std::uint64_t reverseBits(std::uint64_t value)
+	{
+		value = ((value >> 1) & 0x5555555555555555ull) | ((value & 0x5555555555555555ull) << 1);
+		value = ((value >> 2) & 0x3333333333333333ull) | ((value & 0x3333333333333333ull) << 2);
+		value = ((value >> 4) & 0x0F0F0F0F0F0F0F0Full) | ((value & 0x0F0F0F0F0F0F0F0Full) << 4);
+		value = ((value >> 8) & 0x00FF00FF00FF00FFull) | ((value & 0x00FF00FF00FF00FFull) << 8);
+		value = ((value >> 16) & 0x0000FFFF0000FFFFull) | ((value & 0x0000FFFF0000FFFFull) << 16);
+
+		return (value >> 32) | (value << 32);
+	}
+
+	inline double getSymmetry(const std::vector<std::uint64_t>& raster, const std::int32_t size, const std::uint64_t count)
+	{
+		std::size_t wordsPerRow = (std::size_t(size) + 63) / 64;
+
+		std::uint64_t mirroredX = 0;
+		std::uint64_t mirroredY = 0;
+		std::uint64_t rotated = 0;
+
+		std::int32_t shift = static_cast<std::int32_t>(wordsPerRow * 64) - size;
+
+		for (std::int32_t y = 0; y < size; y++)
+		{
+			const std::uint64_t* row = raster.data() + y * wordsPerRow;
+			const std::uint64_t* opposite = raster.data() + (size - 1 - y) * wordsPerRow;
+
+			for (std::size_t w = 0; w < wordsPerRow; w++)
+			{
+				std::size_t mirror = wordsPerRow - 1 - w;
+
+				std::uint64_t low = reverseBits(row[mirror]);
+				std::uint64_t high = mirror > 0 ? reverseBits(row[mirror - 1]) : 0;
+
+				std::uint64_t reversed = shift > 0 ? (low >> shift) | (high << (64 - shift)) : low;
+
+				std::uint64_t lowOpposite = reverseBits(opposite[mirror]);
+				std::uint64_t highOpposite = mirror > 0 ? reverseBits(opposite[mirror - 1]) : 0;
+
+				std::uint64_t reversedOpposite = shift > 0 ? (lowOpposite >> shift) | (highOpposite << (64 - shift)) : lowOpposite;
+
+				mirroredX += ifs::countBits(row[w] & reversed);
+				mirroredY += ifs::countBits(row[w] & opposite[w]);
+				rotated += ifs::countBits(row[w] & reversedOpposite);
+			}
+		}
+
+		return double(glm::max(glm::max(mirroredX, mirroredY), rotated)) / double(count);
+	}
+
+	inline std::vector<ifs::Map> createMaps(const std::uint64_t index, const Settings& settings)
+	{
+		ifs::Random random((std::uint64_t(static_cast<std::uint32_t>(settings.seed)) << 40) ^ index);
+
+		auto uniform = [&](const float lower, const float upper)
+		{
+			return lower + (upper - lower) * random.nextFloat();
+		};
+
+		std::int32_t numMaps = settings.minMaps + static_cast<std::int32_t>(random.next() % std::uint64_t(settings.maxMaps - settings.minMaps + 1));
+
+		std::vector<ifs::Map> maps;
+
+		for (std::int32_t i = 0; i < numMaps; i++)
+		{
+			float angle = uniform(0.0f, 6.2831853071795864769f);
+
+			float scaleX = uniform(settings.minScale, settings.maxScale) * (random.next() & 1 ? -1.0f : 1.0f);
+			float scaleY = uniform(settings.minScale, settings.maxScale);
+			float shear = uniform(-settings.maxShear, settings.maxShear);
+
+			glm::mat2x2 rotation(glm::vec2(std::cos(angle), std::sin(angle)), glm::vec2(-std::sin(angle), std::cos(angle)));
+
+			glm::mat2x2 matrix = rotation * glm::mat2x2(glm::vec2(scaleX, 0.0f), glm::vec2(shear, scaleY));
+
+			ifs::Map map(matrix, glm::vec2(uniform(-1.0f, 1.0f), uniform(-1.0f, 1.0f)));
+
+			float contraction = ifs::getContraction({ map });
+
+			if (contraction > settings.maxContraction)
+			{
+				float factor = settings.maxContraction / contraction;
+
+				map.a *= factor;
+				map.b *= factor;
+				map.c *= factor;
+				map.d *= factor;
+			}
+
+			maps.push_back(map);
+		}
+
+		return maps;
+	}
+
+	class Screener
+	{
+	public:
+		static constexpr std::int32_t warmup = 64;
+		static constexpr std::int32_t numSamples = 4096;
+
+	private:
+		struct Worker
+		{
+			std::shared_ptr<ifs::BoxCounter> boxCounter;
+
+			std::vector<std::uint64_t> raster;
+
+			std::vector<Result> results;
+
+			std::uint64_t numRejected = 0;
+		};
+
+		Settings settings;
+
+		std::int32_t numThreads;
+
+		std::size_t wordsPerRow;
+
+		std::uint64_t numRejected;
+
+		bool evaluate(Worker& worker, Result& result) const
+		{
+			std::int32_t size = this->settings.resolution;
+
+			ifs::AliasTable aliasTable(ifs::getWeights(result.maps));
+
+			ifs::Random random(~result.index);
+
+			glm::vec2 point(0.0f);
+
+			glm::vec2 lower(std::numeric_limits<float>::infinity());
+			glm::vec2 upper(-std::numeric_limits<float>::infinity());
+
+			for (std::int32_t i = 0; i < warmup + numSamples; i++)
+			{
+				const ifs::Map& map = result.maps[aliasTable.sample(random.next())];
+
+				point = glm::vec2(map.a * point.x + map.b * point.y + map.e, map.c * point.x + map.d * point.y + map.f);
+
+				if (i >= warmup)
+				{
+					lower = glm::min(lower, point);
+					upper = glm::max(upper, point);
+				}
+			}
+
+			glm::vec2 extent = upper - lower;
+
+			if (!std::isfinite(extent.x) || !std::isfinite(extent.y) || glm::min(extent.x, extent.y) <= 1e-3f * glm::max(extent.x, extent.y))
+			{
+				return false;
+			}
+
+			std::fill(worker.raster.begin(), worker.raster.end(), 0ull);
+
+			glm::vec2 scale = glm::vec2(float(size)) / extent;
+
+			for (std::int32_t i = 0; i < this->settings.numPoints; i++)
+			{
+				const ifs::Map& map = result.maps[aliasTable.sample(random.next())];
+
+				point = glm::vec2(map.a * point.x + map.b * point.y + map.e, map.c * point.x + map.d * point.y + map.f);
+
+				glm::ivec2 pixel = glm::clamp(glm::ivec2((point - lower) * scale), glm::ivec2(0), glm::ivec2(size - 1));
+
+				worker.raster[pixel.y * this->wordsPerRow + (pixel.x >> 6)] |= std::uint64_t(1) << (pixel.x & 63);
+			}
+
+			std::uint64_t count = 0;
+
+			for (const auto word : worker.raster)
+			{
+				count += ifs::countBits(word);
+			}
+
+			worker.boxCounter->update([&](const std::int32_t y, std::uint64_t* row)
+			{
+				std::copy(worker.raster.begin() + y * this->wordsPerRow, worker.raster.begin() + (y + 1) * this->wordsPerRow, row);
+			});
+
+			result.bounds = glm::dvec4(lower.x, upper.x, lower.y, upper.y);
+			result.coverage = double(count) / (double(size) * size);
+			result.dimension = worker.boxCounter->getDimension();
+			result.symmetry = getSymmetry(worker.raster, size, count);
+
+			if (!std::isfinite(result.dimension))
+			{
+				return false;
+			}
+
+			double coverageScore = 1.0 - glm::min(1.0, glm::abs(result.coverage - this->settings.targetCoverage) / glm::max(double(this->settings.targetCoverage), 1e-3));
+			double dimensionScore = 1.0 - glm::min(1.0, glm::abs(result.dimension - this->settings.targetDimension) / 0.5);
+
+			result.score = this->settings.weightCoverage * coverageScore + this->settings.weightDimension * dimensionScore + this->settings.weightSymmetry * result.symmetry;
+
+			return true;
+		}
+
+	public:
+		Screener(const Settings& settings = Settings(), const std::int32_t numThreads = 0) :
+			settings(settings), numRejected(0)
+		{
+			this->numThreads = numThreads > 0 ? numThreads : glm::max(1, static_cast<std::int32_t>(std::thread::hardware_concurrency()));
+
+			this->settings.resolution = glm::clamp(this->settings.resolution, 16, 1024);
+			this->settings.minMaps = glm::max(this->settings.minMaps, 1);
+			this->settings.maxMaps = glm::max(this->settings.maxMaps, this->settings.minMaps);
+			this->settings.numResults = glm::max(this->settings.numResults, 1);
+			this->settings.numPoints = glm::max(this->settings.numPoints, 1024);
+			this->settings.maxContraction = glm::clamp(this->settings.maxContraction, 0.05f, 0.99f);
+
+			this->wordsPerRow = (std::size_t(this->settings.resolution) + 63) / 64;
+		}
+
+		std::vector<Result> screen()
+		{
+			std::vector<Worker> workers(this->numThreads);
+
+			std::atomic<std::int64_t> next(0);
+
+			ifs::parallel(this->numThreads, [&](const std::int32_t t)
+			{
+				Worker& worker = workers[t];
+
+				worker.boxCounter = std::make_shared<ifs::BoxCounter>(glm::ivec2(this->settings.resolution));
+				worker.raster.resize(this->wordsPerRow * this->settings.resolution);
+
+				for (std::int64_t index = next++; index < this->settings.numCandidates; index = next++)
+				{
+					Result result;
+
+					result.index = static_cast<std::uint64_t>(index);
+					result.maps = createMaps(result.index, this->settings);
+
+					if (!this->evaluate(worker, result))
+					{
+						worker.numRejected++;
+
+						continue;
+					}
+
+					worker.results.push_back(result);
+
+					std::push_heap(worker.results.begin(), worker.results.end(), std::greater<Result>());
+
+					if (static_cast<std::int32_t>(worker.results.size()) > this->settings.numResults)
+					{
+						std::pop_heap(worker.results.begin(), worker.results.end(), std::greater<Result>());
+
+						worker.results.pop_back();
+					}
+				}
+			});
+
+			std::vector<Result> results;
+
+			this->numRejected = 0;
+
+			for (const auto& worker : workers)
+			{
+				results.insert(results.end(), worker.results.begin(), worker.results.end());
+
+				this->numRejected += worker.numRejected;
+			}
+
+			std::sort(results.begin(), results.end(), std::greater<Result>());
+
+			if (static_cast<std::int32_t>(results.size()) > this->settings.numResults)
+			{
+				results.resize(this->settings.numResults);
+			}
+
+			return results;
+		}
+
+		std::uint64_t getNumRejected() const
+		{
+			return this->numRejected;
+		}
+
+		std::int32_t getNumThreads() const
+		{
+			return this->numThreads;
+		}
+	};
+}
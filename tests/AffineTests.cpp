@@ -0,0 +1,144 @@
+#include "../source/Fractals.hpp"
+
+namespace
+{
+	std::int32_t failures = 0;
+
+	void check(const bool condition, const std::string& message)
+	{
+		if (!condition)
+		{
+			std::cerr << "FAILED: " << message << std::endl;
+
+			failures++;
+		}
+	}
+
+	std::vector<bool> readSet(fractals::Affine& affine, const glm::ivec2& size)
+	{
+		affine.render(size, affine.getPreferredViewport());
+
+		img::ImagePtr image = affine.exportImage();
+
+		std::vector<bool> set(image->pixels.size());
+
+		for (std::size_t i = 0; i < set.size(); i++)
+		{
+			std::uint32_t pixel = image->pixels[i];
+
+			set[i] = (pixel & 0xFF) == 0x00 && ((pixel >> 8) & 0xFF) == 0xFF;
+		}
+
+		return set;
+	}
+
+	void testGatherAfterReset()
+	{
+		glm::ivec2 size(256, 256);
+
+		auto fractal = fractals::Affine::createSierpinskiTriangle();
+
+		fractals::Affine affine(size, fractal, fractals::Affine::InitialSet({ }, "1"));
+
+		affine.setIteration(ifs::Iteration::Gather);
+
+		check(affine.getIteration() == ifs::Iteration::Gather, "Sierpinski triangle is gatherable");
+
+		ifs::Hutchinson hutchinson(fractals::Affine::toMaps(fractal.affineTransforms), size, fractal.viewport.viewport);
+
+		hutchinson.setIteration(ifs::Iteration::Gather);
+
+		for (std::int32_t generations : { 1, 2, 5 })
+		{
+			affine.reset();
+
+			affine.iterate(generations);
+
+			hutchinson.initialize([&](const std::int32_t, std::uint64_t* row)
+			{
+				std::fill(row, row + hutchinson.getWordsPerRow(), ~0ull);
+			});
+
+			for (std::int32_t i = 0; i < generations; i++)
+			{
+				hutchinson.iterate();
+			}
+
+			auto set = readSet(affine, size);
+
+			std::size_t mismatches = 0;
+
+			for (std::int32_t y = 0; y < size.y; y++)
+			{
+				for (std::int32_t x = 0; x < size.x; x++)
+				{
+					mismatches += set[y * size.x + x] != hutchinson.get(x, y);
+				}
+			}
+
+			check(mismatches == 0, "gather after reset differs from the CPU engine in " + std::to_string(mismatches) + " pixels after " + std::to_string(generations) + " generation(s)");
+		}
+
+		check(glGetError() == GL_NO_ERROR, "no GL errors");
+	}
+}
+
+int main()
+{
+	RAIIWrapper<bool> glfwIsInit(static_cast<bool>(glfwInit()), [](const bool) { glfwTerminate(); });
+
+	if (!glfwIsInit)
+	{
+		std::cout << "Skipped: GLFW is not available." << std::endl;
+
+		return 77;
+	}
+
+	glfwWindowHint(GLFW_VISIBLE, false);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, true);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+
+	RAIIWrapper<GLFWwindow*> window(glfwCreateWindow(256, 256, "Affine Tests", nullptr, nullptr), glfwDestroyWindow);
+
+	if (!window)
+	{
+		std::cout << "Skipped: no OpenGL 4.2 context." << std::endl;
+
+		return 77;
+	}
+
+	glfwMakeContextCurrent(window);
+
+	if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress) || !gl::extensionAvailable("GL_ARB_shader_image_load_store"))
+	{
+		std::cout << "Skipped: GL_ARB_shader_image_load_store is not available." << std::endl;
+
+		return 77;
+	}
+
+	RAIIWrapper<GLuint> vertexArray(glCreate(VertexArray)(), glDelete(VertexArray));
+
+	glBindVertexArray(vertexArray);
+
+	try
+	{
+		testGatherAfterReset();
+	}
+	catch (const std::exception& error)
+	{
+		check(false, error.what());
+	}
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " check(s) failed." << std::endl;
+
+		return 1;
+	}
+
+	std::cout << "All affine tests passed." << std::endl;
+
+	return 0;
+}
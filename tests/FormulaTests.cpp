@@ -0,0 +1,147 @@
+#include "../source/Formula.hpp"
+
+namespace
+{
+	std::int32_t failures = 0;
+
+	void check(const bool condition, const std::string& message)
+	{
+		if (!condition)
+		{
+			std::cerr << "FAILED: " << message << std::endl;
+
+			failures++;
+		}
+	}
+
+	bool near(const glm::dvec2& a, const glm::dvec2& b)
+	{
+		return glm::length(a - b) <= 1e-9 * glm::max(1.0, glm::length(b));
+	}
+
+	std::shared_ptr<formula::Expression> parse(const std::string& source, const std::vector<formula::Variable>& variables)
+	{
+		std::string error;
+
+		auto expression = formula::Expression::parse(source, variables, error);
+
+		check(expression != nullptr, "parse '" + source + "': " + error);
+
+		return expression;
+	}
+
+	glm::dvec2 evaluate(const std::string& source, const double x)
+	{
+		auto expression = parse(source, { formula::Variable("x", true) });
+
+		if (!expression)
+		{
+			return glm::dvec2(0.0);
+		}
+
+		double re = 0.0;
+		double im = 0.0;
+
+		const double* values = &x;
+
+		expression->compileProgram().evaluate({ values }, { nullptr }, 1, &re, &im);
+
+		return glm::dvec2(re, im);
+	}
+
+	void testConstants()
+	{
+		const double pi = 3.14159265358979323846;
+
+		struct
+		{
+			std::string source;
+			glm::dvec2 expected;
+		}
+		cases[] =
+		{
+			{ "sqrt(-1)", glm::dvec2(0.0, 1.0) },
+			{ "sqrt(-4)", glm::dvec2(0.0, 2.0) },
+			{ "log(-1)", glm::dvec2(0.0, pi) },
+			{ "(-8)^(1/3)", glm::dvec2(1.0, std::sqrt(3.0)) },
+			{ "(-2)^3", glm::dvec2(-8.0, 0.0) },
+			{ "sqrt(4)", glm::dvec2(2.0, 0.0) },
+			{ "log(1)", glm::dvec2(0.0, 0.0) },
+		};
+
+		for (const auto& test : cases)
+		{
+			auto expression = parse(test.source, { });
+
+			if (!expression)
+			{
+				continue;
+			}
+
+			auto code = expression->compileGLSL("f", false, true);
+
+			check(code.find("0.0 / 0.0") == std::string::npos, "'" + test.source + "' folds to NaN: " + code);
+
+			glm::dvec2 value = evaluate(test.source, 0.0);
+
+			check(near(value, test.expected), "'" + test.source + "' evaluates to (" + std::to_string(value.x) + ", " + std::to_string(value.y) + ")");
+		}
+	}
+
+	void testVariables()
+	{
+		check(near(evaluate("sqrt(x)", -9.0), glm::dvec2(0.0, 3.0)), "sqrt(x) at x = -9");
+		check(near(evaluate("sqrt(x)", 9.0), glm::dvec2(3.0, 0.0)), "sqrt(x) at x = 9");
+		check(near(evaluate("log(x)", -1.0), glm::dvec2(0.0, 3.14159265358979323846)), "log(x) at x = -1");
+		check(near(evaluate("log(-x)", 1.0), glm::dvec2(0.0, 3.14159265358979323846)), "log(-x) at x = 1");
+		check(near(evaluate("x^0.5", -4.0), glm::dvec2(0.0, 2.0)), "x^0.5 at x = -4");
+		check(near(evaluate("x^(1/3)", -8.0), glm::dvec2(1.0, std::sqrt(3.0))), "x^(1/3) at x = -8");
+		check(near(evaluate("x^1001", -1.0), glm::dvec2(-1.0, 0.0)), "x^1001 at x = -1");
+		check(near(evaluate("sqrt(x) * sqrt(x)", -2.0), glm::dvec2(-2.0, 0.0)), "sqrt(x) * sqrt(x) at x = -2");
+	}
+
+	void testTypes()
+	{
+		auto expression = parse("sqrt(x * x + 1) + log(exp(x)) + abs(x)^1.5", { formula::Variable("x", true) });
+
+		check(expression && expression->isReal(), "non-negative arguments stay on the real path");
+
+		expression = parse("sqrt(x)", { formula::Variable("x", true) });
+
+		check(expression && !expression->isReal(), "sqrt of a real variable is complex");
+
+		if (expression)
+		{
+			auto code = expression->compileGLSL("f", false, true);
+
+			check(code.find("formulaSqrt(vec2(x, 0.0))") != std::string::npos, "sqrt of a real variable uses formulaSqrt: " + code);
+		}
+
+		expression = parse("log(x)", { formula::Variable("x", true) });
+
+		if (expression)
+		{
+			auto code = expression->compileGLSL("f", true, false);
+
+			check(code.find("formulaLog(dvec2(x, 0.0))") != std::string::npos, "log of a real variable uses formulaLog: " + code);
+		}
+	}
+}
+
+int main()
+{
+	testConstants();
+	testVariables();
+	testTypes();
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " check(s) failed." << std::endl;
+
+		return 1;
+	}
+
+	std::cout << "All formula tests passed." << std::endl;
+
+	return 0;
+}
@@ -0,0 +1,419 @@
+#include "../source/Collage.hpp"
+#include "../source/Screening.hpp"
+
+namespace
+{
+	std::int32_t failures = 0;
+
+	void check(const bool condition, const std::string& message)
+	{
+		if (!condition)
+		{
+			std::cerr << "FAILED: " << message << std::endl;
+
+			failures++;
+		}
+	}
+
+	collage::Bitmap createSierpinski(const std::int32_t size)
+	{
+		collage::Bitmap bitmap(size);
+
+		for (std::int32_t y = 0; y < size; y++)
+		{
+			for (std::int32_t x = 0; x < size; x++)
+			{
+				if ((x & y) == 0)
+				{
+					bitmap.set(x, y);
+				}
+			}
+		}
+
+		return bitmap;
+	}
+
+	collage::Bitmap createShape(const std::int32_t size, const std::int32_t extent, const bool disc)
+	{
+		collage::Bitmap bitmap(size);
+
+		double center = 0.5 * size;
+
+		for (std::int32_t y = 0; y < size; y++)
+		{
+			for (std::int32_t x = 0; x < size; x++)
+			{
+				glm::dvec2 offset = glm::dvec2(x + 0.5, y + 0.5) - center;
+
+				if (disc ? glm::length(offset) <= 0.5 * extent : glm::max(glm::abs(offset.x), glm::abs(offset.y)) <= 0.5 * extent)
+				{
+					bitmap.set(x, y);
+				}
+			}
+		}
+
+		return bitmap;
+	}
+
+	std::vector<bool> getAttractor(const std::vector<ifs::Map>& maps, const std::int32_t size, const std::int32_t generations)
+	{
+		ifs::Hutchinson hutchinson(maps, glm::ivec2(size), glm::dvec4(0.0, 1.0, 0.0, 1.0), 2);
+
+		hutchinson.initialize([&](const std::int32_t, std::uint64_t* row)
+		{
+			std::fill(row, row + hutchinson.getWordsPerRow(), ~0ull);
+		});
+
+		for (std::int32_t i = 0; i < generations; i++)
+		{
+			hutchinson.iterate();
+		}
+
+		std::vector<bool> attractor(std::size_t(size) * std::size_t(size));
+
+		for (std::int32_t y = 0; y < size; y++)
+		{
+			for (std::int32_t x = 0; x < size; x++)
+			{
+				attractor[y * size + x] = hutchinson.get(x, y);
+			}
+		}
+
+		return attractor;
+	}
+
+	std::vector<ifs::Map> getSierpinskiMaps()
+	{
+		return
+		{
+			ifs::Map(glm::mat2x2(0.5f), glm::vec2(0.0f, 0.0f)),
+			ifs::Map(glm::mat2x2(0.5f), glm::vec2(0.5f, 0.0f)),
+			ifs::Map(glm::mat2x2(0.5f), glm::vec2(0.25f, 0.5f)),
+		};
+	}
+
+	void testHutchinsonIterations()
+	{
+		for (std::int32_t size : { 256, 300 })
+		{
+			std::vector<std::shared_ptr<ifs::Hutchinson>> engines;
+
+			for (ifs::Iteration iteration : { ifs::Iteration::Scatter, ifs::Iteration::Gather, ifs::Iteration::Frontier })
+			{
+				auto hutchinson = std::make_shared<ifs::Hutchinson>(getSierpinskiMaps(), glm::ivec2(size), glm::dvec4(0.0, 1.0, 0.0, 1.0), 2);
+
+				hutchinson->setIteration(iteration);
+
+				check(hutchinson->getIteration() == iteration, "Sierpinski triangle supports iteration " + std::to_string(static_cast<int>(iteration)));
+
+				hutchinson->initialize([&](const std::int32_t, std::uint64_t* row)
+				{
+					std::fill(row, row + hutchinson->getWordsPerRow(), ~0ull);
+				});
+
+				engines.push_back(hutchinson);
+			}
+
+			for (std::int32_t generation = 1; generation <= 10; generation++)
+			{
+				for (auto& hutchinson : engines)
+				{
+					hutchinson->iterate();
+				}
+
+				for (std::size_t i = 1; i < engines.size(); i++)
+				{
+					std::size_t mismatches = 0;
+
+					for (std::int32_t y = 0; y < size; y++)
+					{
+						for (std::int32_t x = 0; x < size; x++)
+						{
+							mismatches += engines[i]->get(x, y) != engines[0]->get(x, y);
+						}
+					}
+
+					check(mismatches == 0, "iteration " + std::to_string(i) + " differs from scatter in " + std::to_string(mismatches) + " pixels after " + std::to_string(generation) + " generation(s) at " + std::to_string(size));
+					check(engines[i]->getCount() == engines[0]->getCount(), "iteration " + std::to_string(i) + " counts " + std::to_string(engines[i]->getCount()) + " pixels instead of " + std::to_string(engines[0]->getCount()));
+				}
+			}
+
+			check(engines[2]->getFrontierWords() > 0, "frontier iteration keeps a frontier at " + std::to_string(size));
+		}
+
+		ifs::Hutchinson hutchinson(getSierpinskiMaps(), glm::ivec2(256), glm::dvec4(0.0, 1.0, 0.0, 1.0), 2);
+
+		hutchinson.initialize([&](const std::int32_t, std::uint64_t* row)
+		{
+			std::fill(row, row + hutchinson.getWordsPerRow(), ~0ull);
+		});
+
+		for (std::int32_t i = 0; i < 8; i++)
+		{
+			hutchinson.iterate();
+		}
+
+		check(hutchinson.getCount() == 4 * 2187, "Sierpinski triangle at 256 converges to " + std::to_string(hutchinson.getCount()) + " pixels instead of 4 * 3^7");
+		check(hutchinson.getChanged() == 0, "Sierpinski triangle at 256 is a fixpoint after 8 generations");
+	}
+
+	void testBoxCounter()
+	{
+		const std::int32_t size = 512;
+
+		collage::Bitmap sierpinski = createSierpinski(size);
+
+		std::vector<std::uint64_t> raster(sierpinski.getRow(0), sierpinski.getRow(0) + sierpinski.getWordsPerRow() * size);
+
+		auto fill = [&](const std::int32_t y, std::uint64_t* row)
+		{
+			std::copy(raster.begin() + y * sierpinski.getWordsPerRow(), raster.begin() + (y + 1) * sierpinski.getWordsPerRow(), row);
+		};
+
+		ifs::BoxCounter boxCounter(glm::ivec2(sierpinski.getSize()));
+
+		boxCounter.update(fill);
+
+		check(glm::abs(boxCounter.getDimension() - std::log2(3.0)) < 0.01, "Sierpinski triangle dimension is " + std::to_string(boxCounter.getDimension()) + " instead of 1.585");
+
+		for (std::int32_t level = 0; level < 9; level++)
+		{
+			check(boxCounter.getBoxes(level) == static_cast<std::uint64_t>(std::pow(3.0, 9 - level)), "Sierpinski triangle covers " + std::to_string(boxCounter.getBoxes(level)) + " boxes at level " + std::to_string(level));
+		}
+
+		glm::ivec2 numTiles = boxCounter.getNumTiles();
+
+		std::vector<std::uint8_t> dirtyTiles(std::size_t(numTiles.x) * std::size_t(numTiles.y), 0);
+
+		std::uint64_t removed = 0;
+
+		for (std::int32_t y = 256; y < 320; y++)
+		{
+			for (std::int32_t x = 0; x < 192; x++)
+			{
+				std::uint64_t& word = raster[y * sierpinski.getWordsPerRow() + (x >> 6)];
+
+				removed += (word >> (x & 63)) & 1ull;
+
+				word &= ~(1ull << (x & 63));
+
+				dirtyTiles[std::size_t(y / ifs::BoxCounter::tileSize) * std::size_t(numTiles.x) + std::size_t(x / ifs::BoxCounter::tileSize)] = 1;
+			}
+		}
+
+		boxCounter.update(fill, dirtyTiles);
+
+		check(boxCounter.getNumChanged() == removed, "incremental update sees " + std::to_string(boxCounter.getNumChanged()) + " changed pixels instead of " + std::to_string(removed));
+
+		ifs::BoxCounter reference(glm::ivec2(sierpinski.getSize()));
+
+		reference.update(fill);
+
+		for (std::int32_t level = 0; level < boxCounter.getNumLevels(); level++)
+		{
+			check(boxCounter.getBoxes(level) == reference.getBoxes(level), "incremental update counts " + std::to_string(boxCounter.getBoxes(level)) + " boxes at level " + std::to_string(level) + " instead of " + std::to_string(reference.getBoxes(level)));
+		}
+	}
+
+	void testTileStore()
+	{
+		ifs::TileStore store(glm::ivec2(1000, 700));
+
+		check(store.getNumTiles() == glm::ivec2(4, 3), "1000x700 store has " + std::to_string(store.getNumTiles().x) + "x" + std::to_string(store.getNumTiles().y) + " tiles");
+		check(store.getNumAllocated() == 0, "new store allocates no tiles");
+
+		std::vector<glm::ivec2> pixels = { glm::ivec2(0, 0), glm::ivec2(255, 255), glm::ivec2(256, 0), glm::ivec2(999, 699), glm::ivec2(999, 698) };
+
+		for (const auto& pixel : pixels)
+		{
+			store.set(pixel.x, pixel.y);
+		}
+
+		check(store.getNumAllocated() == 3, "five pixels in three tiles allocate " + std::to_string(store.getNumAllocated()) + " tiles");
+		check(store.hasTile(0, 0) && store.hasTile(1, 0) && store.hasTile(3, 2) && !store.hasTile(2, 1), "only touched tiles are allocated");
+
+		for (const auto& pixel : pixels)
+		{
+			check(store.get(pixel.x, pixel.y), "pixel (" + std::to_string(pixel.x) + ", " + std::to_string(pixel.y) + ") is set");
+		}
+
+		check(!store.get(1, 0) && !store.get(255, 254) && !store.get(500, 500) && !store.get(998, 699), "neighboring pixels stay clear");
+
+		check(store.getRow(699, 999 / 64) == 1ull << (999 % 64), "row word holds the last pixel");
+		check(store.getRow(500, 500 / 64) == 0ull, "row word of an unallocated tile is empty");
+
+		store.reset(glm::ivec2(100000, 100000));
+
+		store.set(0, 0);
+		store.set(50000, 50000);
+		store.set(99999, 99999);
+
+		check(store.getNumAllocated() == 3 && store.get(50000, 50000) && !store.get(50000, 50001), "100000x100000 store holds three pixels");
+		check(store.getMemory() < std::size_t(2) << 20, "100000x100000 store with three pixels takes " + std::to_string(store.getMemory()) + " bytes");
+	}
+
+	void testCodeTree()
+	{
+		std::vector<ifs::Map> maps =
+		{
+			ifs::Map(glm::mat2x2(0.5f), glm::vec2(0.0f, 0.0f)),
+			ifs::Map(glm::mat2x2(0.5f), glm::vec2(0.5f, 0.0f)),
+			ifs::Map(glm::mat2x2(0.5f), glm::vec2(0.0f, 0.5f)),
+		};
+
+		ifs::CodeTree codeTree(maps, 2);
+
+		check(codeTree.isValid(), "Sierpinski code tree has a bounding ball");
+
+		collage::Bitmap sierpinski = createSierpinski(256);
+
+		codeTree.render(glm::ivec2(256), glm::dvec4(0.0, 1.0, 0.0, 1.0));
+
+		std::size_t mismatches = 0;
+
+		for (std::int32_t y = 0; y < 256; y++)
+		{
+			for (std::int32_t x = 0; x < 256; x++)
+			{
+				mismatches += codeTree.getCoverage().get(x, y) != sierpinski.get(x, y);
+			}
+		}
+
+		check(mismatches == 0, "code tree coverage differs from the Sierpinski raster in " + std::to_string(mismatches) + " pixels");
+
+		codeTree.render(glm::ivec2(4096), glm::dvec4(0.0, 1.0, 0.0, 1.0));
+
+		check(codeTree.getCoverage().getNumAllocated() == 81, "4096x4096 Sierpinski coverage allocates " + std::to_string(codeTree.getCoverage().getNumAllocated()) + " of 256 tiles instead of 3^4");
+
+		codeTree.render(glm::ivec2(4096), glm::dvec4(0.6, 1.0, 0.6, 1.0));
+
+		check(codeTree.getCoverage().getNumAllocated() == 0 && codeTree.getNumCulled() > 0, "empty viewport allocates no tiles");
+	}
+
+	void testSymmetry()
+	{
+		for (std::int32_t size : { 64, 100, 130 })
+		{
+			std::size_t wordsPerRow = (std::size_t(size) + 63) / 64;
+
+			ifs::Random random(size);
+
+			std::vector<bool> noise(std::size_t(size) * std::size_t(size));
+
+			for (std::size_t i = 0; i < noise.size(); i++)
+			{
+				noise[i] = random.nextFloat() < 0.3f;
+			}
+
+			auto getScore = [&](const std::function<bool(const std::int32_t x, const std::int32_t y)>& pixel)
+			{
+				std::vector<std::uint64_t> raster(wordsPerRow * std::size_t(size), 0ull);
+
+				std::uint64_t count = 0;
+
+				for (std::int32_t y = 0; y < size; y++)
+				{
+					for (std::int32_t x = 0; x < size; x++)
+					{
+						if (pixel(x, y))
+						{
+							raster[y * wordsPerRow + (x >> 6)] |= 1ull << (x & 63);
+
+							count++;
+						}
+					}
+				}
+
+				return screening::getSymmetry(raster, size, count);
+			};
+
+			auto at = [&](const std::int32_t x, const std::int32_t y)
+			{
+				return noise[std::size_t(y) * std::size_t(size) + std::size_t(x)];
+			};
+
+			std::string name = " at " + std::to_string(size);
+
+			double mirroredX = getScore([&](const std::int32_t x, const std::int32_t y) { return at(glm::min(x, size - 1 - x), y); });
+			double mirroredY = getScore([&](const std::int32_t x, const std::int32_t y) { return at(x, glm::min(y, size - 1 - y)); });
+			double rotated = getScore([&](const std::int32_t x, const std::int32_t y) { return y < size / 2 ? at(x, y) : at(size - 1 - x, size - 1 - y); });
+			double asymmetric = getScore(at);
+
+			check(mirroredX == 1.0, "raster mirrored in x scores " + std::to_string(mirroredX) + name);
+			check(mirroredY == 1.0, "raster mirrored in y scores " + std::to_string(mirroredY) + name);
+			check(rotated == 1.0, "raster rotated by 180 degrees scores " + std::to_string(rotated) + name);
+			check(asymmetric < 0.5, "random raster scores " + std::to_string(asymmetric) + name);
+		}
+	}
+
+	void testEncoderSelfSimilar()
+	{
+		collage::Bitmap target = createSierpinski(128);
+
+		collage::Result result = collage::Encoder(target).encode();
+
+		check(result.maps.size() == 3, "Sierpinski triangle encodes to " + std::to_string(result.maps.size()) + " maps instead of 3");
+		check(result.coverage >= 0.99, "Sierpinski triangle coverage is " + std::to_string(result.coverage));
+		check(result.collageError <= 0.01, "Sierpinski triangle collage error is " + std::to_string(result.collageError));
+
+		for (const auto& map : result.maps)
+		{
+			check(glm::abs(glm::abs(map.getDeterminant()) - 0.25f) < 0.01f, "Sierpinski map scales by " + std::to_string(std::sqrt(glm::abs(map.getDeterminant()))));
+		}
+
+		auto attractor = getAttractor(result.maps, target.getSize(), 10);
+
+		std::size_t mismatches = 0;
+
+		for (std::int32_t y = 0; y < target.getSize(); y++)
+		{
+			for (std::int32_t x = 0; x < target.getSize(); x++)
+			{
+				mismatches += attractor[y * target.getSize() + x] != target.get(x, y);
+			}
+		}
+
+		check(mismatches <= target.count() / 100, "attractor of the encoded maps differs from the target in " + std::to_string(mismatches) + " pixels");
+	}
+
+	void testEncoderNonFractal()
+	{
+		for (bool disc : { true, false })
+		{
+			std::string name = disc ? "disc" : "square";
+
+			collage::Result result = collage::Encoder(createShape(128, disc ? 80 : 64, disc)).encode();
+
+			check(result.maps.size() > 0, name + " encodes to no maps");
+			check(result.coverage >= 0.97, name + " coverage is " + std::to_string(result.coverage));
+			check(result.collageError <= 0.05, name + " collage error is " + std::to_string(result.collageError));
+
+			for (const auto& map : result.maps)
+			{
+				check(glm::abs(map.getDeterminant()) < 1.0f, name + " map is not contractive");
+			}
+		}
+	}
+}
+
+int main()
+{
+	testHutchinsonIterations();
+	testBoxCounter();
+	testTileStore();
+	testCodeTree();
+	testSymmetry();
+	testEncoderSelfSimilar();
+	testEncoderNonFractal();
+
+	if (failures > 0)
+	{
+		std::cerr << failures << " check(s) failed." << std::endl;
+
+		return 1;
+	}
+
+	std::cout << "All IFS tests passed." << std::endl;
+
+	return 0;
+}